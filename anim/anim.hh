@@ -1,8 +1,29 @@
 #pragma once
 
+#include "ticks.hh"
 #include "interpolators.hh"
+#include "bezier.hh"
 #include "animation.hh"
+#include "timeline.hh"
+#include "spline.hh"
+#include "spring.hh"
+#include "compress.hh"
+#include "quantized.hh"
+#include "instanced.hh"
 #include "batch.hh"
 #include "sequence.hh"
+#include "static.hh"
 #include "common.hh"
+#include "components.hh"
+#include "simd.hh"
+#include "crossfade.hh"
+#include "commands.hh"
+#include "world.hh"
+#include "timer.hh"
+#include "script.hh"
 #include "template.hh"
+#include "registry.hh"
+#include "binary.hh"
+#include "text.hh"
+#include "profile.hh"
+#include "trace.hh"
@@ -2,10 +2,11 @@
 
 #include <cassert>
 #include <vector>
-#include <chrono>
 #include <numeric>
+#include <algorithm>
 
 #include "common.hh"
+#include "timed.hh"
 
 
 
@@ -13,67 +14,65 @@ namespace anim {
 
 // runs a list of interpolators synchronously
 template <Interpolatable T>
-class Animation : public IAnimation {
+class Animation : public TimedAnimation {
     std::vector<Interpolator<T>> m_interps;
-    double m_start_time = 0.0f;
-    bool m_is_active = false;
 
 public:
     Animation() = default;
 
     Animation(std::initializer_list<Interpolator<T>> interps)
     : m_interps(interps)
-    { }
-
-    Animation(Interpolator<T> interp) : m_interps { interp } { }
+    {
+        ANIM_PROFILE_ALLOC(T, m_interps.capacity() * sizeof(Interpolator<T>));
+    }
 
-    void add(Interpolator<T> interp) {
-        m_interps.push_back(interp);
+    Animation(Interpolator<T> interp) : m_interps { interp } {
+        ANIM_PROFILE_ALLOC(T, m_interps.capacity() * sizeof(Interpolator<T>));
     }
 
-    void start() override {
-        m_is_active = true;
-        m_start_time = get_time_secs();
+    // eg. the result of fit_linear()
+    explicit Animation(std::vector<Interpolator<T>> interps) : m_interps(std::move(interps)) {
+        assert(!m_interps.empty());
+        ANIM_PROFILE_ALLOC(T, m_interps.capacity() * sizeof(Interpolator<T>));
     }
 
-    void reset() override {
-        m_is_active = false;
-        m_start_time = 0.0f;
+    void add(Interpolator<T> interp) {
+        [[maybe_unused]] auto capacity = m_interps.capacity();
+        m_interps.push_back(interp);
+
+        if (m_interps.capacity() != capacity)
+            ANIM_PROFILE_ALLOC(T, m_interps.capacity() * sizeof(Interpolator<T>));
     }
 
-    [[nodiscard]] double get_progress() const override {
-        return get_time() / get_duration();
+    // moves the end of the last interpolator, eg. when the target moved while animating
+    // keeps the capacity, so this never allocates
+    void retarget(T end) {
+        assert(!m_interps.empty());
+        Interpolator<T> last = m_interps.back();
+        m_interps.pop_back();
+        m_interps.emplace_back(last.get_start(), end, last.get_duration_ticks(), last.get_fn());
     }
 
     [[nodiscard]] double get_duration() const override {
-
-        auto fn = [](double acc, anim::Interpolator<T> const& interp) {
-            return acc + interp.get_duration();
-        };
-
-        return std::accumulate(m_interps.cbegin(), m_interps.cend(), 0.0f, fn);
+        return to_seconds(get_duration_ticks());
     }
 
-    [[nodiscard]] bool is_stopped() const override {
-        return !m_is_active;
-    }
+    [[nodiscard]] Ticks get_duration_ticks() const override {
+        ANIM_PROFILE_COUNT(AnimationDuration);
 
-    [[nodiscard]] bool is_running() const override {
-        if (is_done()) return false;
-        return m_is_active;
-    }
+        auto fn = [](Ticks acc, anim::Interpolator<T> const& interp) {
+            return acc + interp.get_duration_ticks();
+        };
 
-    [[nodiscard]] bool is_done() const override {
-        if (!m_is_active) return false;
-        return get_time() > get_duration();
+        return std::accumulate(m_interps.cbegin(), m_interps.cend(), Ticks::zero(), fn);
     }
 
-    [[nodiscard]] T get(float t) const {
+    [[nodiscard]] T get(Ticks t) const {
 
-        double time_to_interp = 0.0f;
+        Ticks time_to_interp = Ticks::zero();
 
         auto fn = [&](Interpolator<T> const& interp) {
-            time_to_interp += interp.get_duration();
+            time_to_interp += interp.get_duration_ticks();
             bool is_current = t <= time_to_interp;
             return is_current;
         };
@@ -81,19 +80,26 @@ public:
         auto current = std::ranges::find_if(m_interps, fn);
         assert(current != m_interps.end());
 
-        double diff = time_to_interp - t;
-        return current->get(current->get_duration() - diff);
+        Ticks diff = time_to_interp - t;
+        return current->get(current->get_duration_ticks() - diff);
+    }
+
+    // t in seconds
+    [[nodiscard]] T get(double t) const {
+        return get(to_ticks(t));
     }
 
     [[nodiscard]] T get() const {
-        if (m_is_active) {
-            if (is_done()) return m_interps.back().get_end();
-            double t = get_time();
-            return get(t);
+        ANIM_PROFILE_COUNT(AnimationGet);
 
-        } else {
+        auto elapsed = get_elapsed_ticks();
+        if (!elapsed)
             return m_interps.front().get_start();
-        }
+
+        // read the clock once, so the done check and the lookup agree on the time
+        Ticks t = *elapsed;
+        if (t > get_duration_ticks()) return m_interps.back().get_end();
+        return get(t);
     }
 
     T const* operator->() const {
@@ -106,19 +112,6 @@ public:
         return get();
     }
 
-private:
-    [[nodiscard]] double get_time() const {
-        return get_time_secs() - m_start_time;
-    }
-
-    [[nodiscard]] static double get_time_secs() {
-        namespace chrono = std::chrono;
-
-        auto now = chrono::steady_clock::now();
-        auto time = now.time_since_epoch();
-        return chrono::duration_cast<chrono::duration<double>>(time).count();
-    }
-
 };
 
 }
@@ -16,15 +16,23 @@ void Batch::add(IAnimation& anim) {
 }
 
 void Batch::start() {
+    ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
     for (auto& anim : m_anims)
         anim.get().start();
 }
 
 void Batch::reset() {
+    ANIM_TRACE_INSTANT("reset", typeid(*this).name(), this);
     for (auto& anim : m_anims)
         anim.get().reset();
 }
 
+void Batch::start_at(Ticks time) {
+    ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
+    for (auto& anim : m_anims)
+        anim.get().start_at(time);
+}
+
 [[nodiscard]] double Batch::get_progress() const {
     return get_longest().get().get_progress();
 }
@@ -33,6 +41,10 @@ void Batch::reset() {
     return get_longest().get().get_duration();
 }
 
+[[nodiscard]] Ticks Batch::get_duration_ticks() const {
+    return get_longest().get().get_duration_ticks();
+}
+
 [[nodiscard]] bool Batch::is_stopped() const {
     return get_longest().get().is_stopped();
 }
@@ -46,9 +58,10 @@ void Batch::reset() {
 }
 
 [[nodiscard]] std::reference_wrapper<IAnimation> const& Batch::get_longest() const {
+    ANIM_PROFILE_COUNT(BatchLongest);
 
     auto max_fn = [](std::reference_wrapper<IAnimation> const& a, decltype(a) b) {
-        return b.get().get_duration() > a.get().get_duration();
+        return b.get().get_duration_ticks() > a.get().get_duration_ticks();
     };
 
     auto longest = std::ranges::max_element(m_anims, max_fn);
@@ -19,8 +19,10 @@ public:
     void add(IAnimation& anim);
     void start() override;
     void reset() override;
+    void start_at(Ticks time) override;
     [[nodiscard]] double get_progress() const override;
     [[nodiscard]] double get_duration() const override;
+    [[nodiscard]] Ticks get_duration_ticks() const override;
     [[nodiscard]] bool is_stopped() const override;
     [[nodiscard]] bool is_done() const override;
     [[nodiscard]] bool is_running() const override;
@@ -0,0 +1,48 @@
+#include "bezier.hh"
+
+#include <array>
+#include <mutex>
+#include <utility>
+
+namespace anim {
+
+namespace interpolators {
+
+namespace {
+
+constexpr std::size_t max_curves = 256;
+
+std::mutex g_mutex;
+std::array<CubicBezier, max_curves> g_curves; // linear until taken
+std::array<std::array<float, 4>, max_curves> g_params { };
+std::size_t g_count = 0;
+
+template <std::size_t I>
+float runtime_curve(float x) {
+    return g_curves[I](x);
+}
+
+// one function per slot, so a slot fits into a plain function pointer
+constexpr auto runtime_curves = []<std::size_t... I>(std::index_sequence<I...>) {
+    return std::array<EasingFn, max_curves> { &runtime_curve<I>... };
+}(std::make_index_sequence<max_curves>());
+
+}
+
+EasingFn make_cubic_bezier(float x1, float y1, float x2, float y2) {
+    std::array<float, 4> params { x1, y1, x2, y2 };
+    std::scoped_lock lock(g_mutex);
+
+    for (std::size_t i = 0; i < g_count; ++i)
+        if (g_params[i] == params) return runtime_curves[i];
+
+    if (g_count == max_curves) return nullptr;
+
+    g_curves[g_count] = CubicBezier(x1, y1, x2, y2);
+    g_params[g_count] = params;
+    return runtime_curves[g_count++];
+}
+
+}
+
+}
@@ -0,0 +1,354 @@
+#include "binary.hh"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace anim {
+
+namespace binary {
+
+namespace {
+
+struct Layout {
+    std::size_t tracks;
+    std::size_t segments;
+    std::size_t values;
+    std::size_t nodes;
+    std::size_t children;
+    std::size_t size;
+};
+
+[[nodiscard]] Layout get_layout(Header const& header) {
+    Layout layout { };
+    std::size_t offset = sizeof(Header);
+
+    layout.tracks = offset;
+    offset += detail::section_size<Track>(header.track_count);
+    layout.segments = offset;
+    offset += detail::section_size<Segment>(header.segment_count);
+    layout.values = offset;
+    offset += detail::section_size<float>(header.value_count);
+    layout.nodes = offset;
+    offset += detail::section_size<Node>(header.node_count);
+    layout.children = offset;
+    offset += detail::section_size<std::uint32_t>(header.child_count);
+
+    layout.size = offset;
+    return layout;
+}
+
+template <typename T>
+void append(std::vector<std::byte>& out, std::span<const T> items) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    std::size_t offset = out.size();
+    out.resize(offset + detail::section_size<T>(items.size()));
+    if (!items.empty())
+        std::memcpy(out.data() + offset, items.data(), items.size_bytes());
+}
+
+// same, straight into a file
+template <typename T>
+[[nodiscard]] bool append(std::FILE* file, std::span<const T> items) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static constexpr std::array<std::byte, 8> s_padding { };
+
+    std::size_t padding = detail::section_size<T>(items.size()) - items.size_bytes();
+    return std::fwrite(items.data(), 1, items.size_bytes(), file) == items.size_bytes()
+        && std::fwrite(s_padding.data(), 1, padding, file) == padding;
+}
+
+}
+
+
+void Writer::begin_track(std::uint32_t components) {
+    assert(!m_track.has_value() && "end_track() was not called");
+    assert(components > 0 && components <= MAX_COMPONENTS);
+
+    m_track = Track {
+        .first_segment = static_cast<std::uint32_t>(m_segments.size()),
+        .segment_count = 0,
+        .components = components,
+        .reserved = 0,
+        .duration = 0,
+    };
+}
+
+void Writer::add_segment(std::span<const float> start, std::span<const float> end, Ticks duration, std::uint32_t easing) {
+    assert(m_track.has_value() && "begin_track() was not called");
+    assert(start.size() == m_track->components && end.size() == m_track->components);
+    assert(easing < interpolators::easings.size());
+    assert(duration >= Ticks::zero());
+
+    // summed in integers, so long tracks do not drift
+    m_track->duration += detail::to_file_time(duration);
+    m_track->segment_count++;
+
+    m_segments.push_back({
+        .end = m_track->duration,
+        .easing = easing,
+        .first_value = static_cast<std::uint32_t>(m_values.size()),
+    });
+
+    m_values.insert(m_values.end(), start.begin(), start.end());
+    m_values.insert(m_values.end(), end.begin(), end.end());
+}
+
+std::uint32_t Writer::end_track() {
+    assert(m_track.has_value() && "begin_track() was not called");
+    assert(m_track->segment_count > 0 && "a track needs at least one segment");
+
+    auto track = static_cast<std::uint32_t>(m_tracks.size());
+    m_tracks.push_back(*m_track);
+    m_track.reset();
+
+    m_nodes.push_back({ .kind = NodeKind::Track, .index = track, .count = 0, .reserved = 0 });
+    return static_cast<std::uint32_t>(m_nodes.size() - 1);
+}
+
+std::uint32_t Writer::add_batch(std::span<const std::uint32_t> children) {
+    return add_node(NodeKind::Batch, children);
+}
+
+std::uint32_t Writer::add_sequence(std::span<const std::uint32_t> children) {
+    return add_node(NodeKind::Sequence, children);
+}
+
+void Writer::set_root(std::uint32_t node) {
+    assert(node < m_nodes.size());
+    m_root = node;
+}
+
+std::size_t Writer::get_size() const {
+    return get_layout(get_header()).size;
+}
+
+Header Writer::get_header() const {
+    return {
+        .magic = MAGIC,
+        .version = VERSION,
+        .flags = 0,
+        .track_count = static_cast<std::uint32_t>(m_tracks.size()),
+        .segment_count = static_cast<std::uint32_t>(m_segments.size()),
+        .value_count = static_cast<std::uint32_t>(m_values.size()),
+        .node_count = static_cast<std::uint32_t>(m_nodes.size()),
+        .child_count = static_cast<std::uint32_t>(m_children.size()),
+        .root = m_root,
+    };
+}
+
+std::vector<std::byte> Writer::finish() const {
+    assert(!m_track.has_value() && "end_track() was not called");
+
+    Header header = get_header();
+    std::vector<std::byte> out;
+    out.reserve(get_layout(header).size);
+
+    append<Header>(out, std::span(&header, 1));
+    append<Track>(out, m_tracks);
+    append<Segment>(out, m_segments);
+    append<float>(out, m_values);
+    append<Node>(out, m_nodes);
+    append<std::uint32_t>(out, m_children);
+
+    assert(out.size() == get_layout(header).size);
+    return out;
+}
+
+// section by section, so the timeline is not copied into one buffer first
+bool Writer::write(char const* path) const {
+    assert(!m_track.has_value() && "end_track() was not called");
+
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) return false;
+
+    Header header = get_header();
+    bool written = append<Header>(file, std::span(&header, 1))
+        && append<Track>(file, m_tracks)
+        && append<Segment>(file, m_segments)
+        && append<float>(file, m_values)
+        && append<Node>(file, m_nodes)
+        && append<std::uint32_t>(file, m_children);
+
+    return std::fclose(file) == 0 && written;
+}
+
+std::uint32_t Writer::add_node(NodeKind kind, std::span<const std::uint32_t> children) {
+    assert(!children.empty());
+    assert(std::ranges::all_of(children, [&](std::uint32_t child) { return child < m_nodes.size(); }));
+
+    auto first = static_cast<std::uint32_t>(m_children.size());
+    m_children.insert(m_children.end(), children.begin(), children.end());
+
+    m_nodes.push_back({ .kind = kind, .index = first, .count = static_cast<std::uint32_t>(children.size()), .reserved = 0 });
+    return static_cast<std::uint32_t>(m_nodes.size() - 1);
+}
+
+std::optional<View> View::open(std::span<const std::byte> data) {
+    if (data.size() < sizeof(Header)) return { };
+    if (reinterpret_cast<std::uintptr_t>(data.data()) % 8 != 0) return { };
+
+    auto const* header = reinterpret_cast<Header const*>(data.data());
+    if (header->magic != MAGIC || header->version != VERSION) return { };
+
+    // counts are 32 bit, so the layout cannot overflow a 64 bit size
+    Layout layout = get_layout(*header);
+    if (layout.size > data.size()) return { };
+
+    View view;
+    view.m_header = header;
+    view.m_tracks = reinterpret_cast<Track const*>(data.data() + layout.tracks);
+    view.m_segments = reinterpret_cast<Segment const*>(data.data() + layout.segments);
+    view.m_values = reinterpret_cast<float const*>(data.data() + layout.values);
+    view.m_nodes = reinterpret_cast<Node const*>(data.data() + layout.nodes);
+    view.m_children = reinterpret_cast<std::uint32_t const*>(data.data() + layout.children);
+    return view;
+}
+
+bool View::verify() const {
+    Header const& header = *m_header;
+
+    for (Track const& track : get_tracks()) {
+        if (track.components == 0 || track.components > MAX_COMPONENTS) return false;
+        if (track.segment_count == 0) return false;
+        if (std::uint64_t(track.first_segment) + track.segment_count > header.segment_count) return false;
+
+        std::int64_t previous = 0;
+        for (Segment const& segment : get_segments(&track - m_tracks)) {
+            if (segment.end < previous) return false;
+            if (segment.easing >= interpolators::easings.size()) return false;
+            if (std::uint64_t(segment.first_value) + 2 * track.components > header.value_count) return false;
+            previous = segment.end;
+        }
+
+        if (track.duration != previous) return false;
+    }
+
+    for (Node const& node : get_nodes()) {
+        switch (node.kind) {
+            case NodeKind::Track:
+                if (node.index >= header.track_count) return false;
+                break;
+
+            case NodeKind::Batch:
+            case NodeKind::Sequence:
+                if (node.count == 0) return false;
+                if (std::uint64_t(node.index) + node.count > header.child_count) return false;
+                break;
+
+            default:
+                return false;
+        }
+    }
+
+    // children must come before their parents, which also rules out cycles
+    for (std::uint32_t i = 0; i < header.node_count; ++i)
+        for (std::uint32_t child : get_children(i))
+            if (child >= i) return false;
+
+    return header.node_count == 0 || header.root < header.node_count;
+}
+
+Ticks View::get_duration_ticks(std::uint32_t node) const {
+    Node const& n = m_nodes[node];
+
+    if (n.kind == NodeKind::Track)
+        return detail::from_file_time(m_tracks[n.index].duration);
+
+    Ticks duration = Ticks::zero();
+    for (std::uint32_t child : get_children(node)) {
+        Ticks child_duration = get_duration_ticks(child);
+        duration = n.kind == NodeKind::Batch ? std::max(duration, child_duration) : duration + child_duration;
+    }
+    return duration;
+}
+
+void View::get(std::uint32_t track, Ticks t, std::span<float> out) const {
+    std::uint32_t components = m_tracks[track].components;
+    assert(out.size() == components);
+
+    auto [segment, weight] = locate(track, t);
+    float const* start = m_values + segment->first_value;
+    float const* end = start + components;
+
+    for (std::uint32_t i = 0; i < components; ++i)
+        out[i] = anim::lerp(start[i], end[i], weight);
+}
+
+View::Location View::locate(std::uint32_t track, Ticks t) const {
+    assert(track < m_header->track_count);
+    auto segments = get_segments(track);
+    std::int64_t time = detail::to_file_time(t);
+
+    if (time <= 0)
+        return { &segments.front(), interpolators::easings[segments.front().easing].fn(0.0f) };
+
+    if (time >= segments.back().end)
+        return { &segments.back(), interpolators::easings[segments.back().easing].fn(1.0f) };
+
+    auto current = std::ranges::lower_bound(segments, time, { }, &Segment::end);
+    std::int64_t start = current == segments.begin() ? 0 : std::prev(current)->end;
+    std::int64_t length = current->end - start;
+    auto x = length > 0 ? static_cast<float>(static_cast<double>(time - start) / static_cast<double>(length)) : 1.0f;
+
+    return { &*current, interpolators::easings[current->easing].fn(x) };
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+: m_data(std::exchange(other.m_data, nullptr))
+, m_size(std::exchange(other.m_size, 0))
+{ }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(char const* path) {
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info { };
+    if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    auto size = static_cast<std::size_t>(info.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping keeps the file alive
+
+    if (data == MAP_FAILED) return false;
+
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data != nullptr)
+        ::munmap(m_data, m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+}
+
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "common.hh"
+#include "components.hh"
+#include "interpolators.hh"
+#include "timed.hh"
+
+// compiled timelines
+// a versioned little-endian format that is used in place, eg. straight from
+// a MappedFile, without any parsing:
+//
+// Header
+// Track[track_count]       keyframes of one value with up to 16 float components
+// Segment[segment_count]   one interpolator each, grouped by track
+// float[value_count]       start and end values of the segments
+// Node[node_count]         composition tree of tracks, batches and sequences
+// uint32[child_count]      child nodes of the batches and sequences
+//
+// Sections follow each other in this order, each starting at a multiple of 8
+// bytes. Easings are stored as their index in interpolators::easings. Times
+// are integer nanoseconds, whatever ANIM_TICKS_PER_SECOND is set to, so they
+// are exact however long a track runs.
+
+namespace anim {
+
+namespace binary {
+
+static_assert(std::endian::native == std::endian::little, "compiled timelines are read in place");
+
+constexpr std::uint32_t MAGIC = 0x4d494e41; // "ANIM"
+constexpr std::uint16_t VERSION = 2;
+constexpr std::uint32_t MAX_COMPONENTS = 16;
+
+struct Header {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t flags;
+    std::uint32_t track_count;
+    std::uint32_t segment_count;
+    std::uint32_t value_count;
+    std::uint32_t node_count;
+    std::uint32_t child_count;
+    std::uint32_t root; // node
+};
+
+struct Track {
+    std::uint32_t first_segment;
+    std::uint32_t segment_count;
+    std::uint32_t components;
+    std::uint32_t reserved;
+    std::int64_t duration; // nanoseconds
+};
+
+struct Segment {
+    std::int64_t end; // nanoseconds since the start of the track
+    std::uint32_t easing;
+    std::uint32_t first_value; // start values, followed by the end values
+};
+
+enum class NodeKind : std::uint32_t {
+    Track,
+    Batch,
+    Sequence,
+};
+
+struct Node {
+    NodeKind kind;
+    std::uint32_t index; // the track, or the first child
+    std::uint32_t count; // number of children
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(Header) == 32 && sizeof(Track) == 24 && sizeof(Segment) == 16 && sizeof(Node) == 16);
+
+namespace detail {
+
+[[nodiscard]] constexpr std::int64_t to_file_time(Ticks ticks) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(ticks).count();
+}
+
+[[nodiscard]] constexpr Ticks from_file_time(std::int64_t nanoseconds) {
+    return std::chrono::round<Ticks>(std::chrono::nanoseconds(nanoseconds));
+}
+
+template <typename T>
+[[nodiscard]] constexpr std::size_t section_size(std::size_t count) {
+    return (count * sizeof(T) + 7) & ~std::size_t(7);
+}
+
+template <Decomposable T>
+[[nodiscard]] std::array<float, Components<T>::count> to_floats(T const& value) {
+    auto components = Components<T>::to_array(value);
+    std::array<float, Components<T>::count> floats;
+    for (std::size_t i = 0; i < floats.size(); ++i)
+        floats[i] = static_cast<float>(components[i]);
+    return floats;
+}
+
+template <Decomposable T>
+[[nodiscard]] T from_floats(float const* floats) {
+    using C = Components<T>;
+    std::array<typename C::value_type, C::count> components;
+    for (std::size_t i = 0; i < C::count; ++i)
+        components[i] = static_cast<typename C::value_type>(floats[i]);
+    return C::from_array(components);
+}
+
+}
+
+// builds a compiled timeline in memory
+// the sections grow independently, so the whole timeline is held until it
+// is written, which write() does section by section without another copy
+class Writer {
+    std::vector<Track> m_tracks;
+    std::vector<Segment> m_segments;
+    std::vector<float> m_values;
+    std::vector<Node> m_nodes;
+    std::vector<std::uint32_t> m_children;
+    std::uint32_t m_root = 0;
+    std::optional<Track> m_track; // between begin_track() and end_track()
+
+public:
+    // adds a track node, or nothing if an easing is not listed in
+    // interpolators::easings, as it could not be read back
+    template <Decomposable T>
+    std::optional<std::uint32_t> add_track(std::span<const Interpolator<T>> interps) {
+        for (auto const& interp : interps)
+            if (!interpolators::find_easing(interp.get_fn()))
+                return { };
+
+        begin_track(Components<T>::count);
+
+        for (auto const& interp : interps) {
+            add_segment(detail::to_floats(interp.get_start()),
+                        detail::to_floats(interp.get_end()),
+                        interp.get_duration_ticks(),
+                        *interpolators::find_easing(interp.get_fn()));
+        }
+
+        return end_track();
+    }
+
+    template <Decomposable T>
+    std::optional<std::uint32_t> add_track(std::initializer_list<Interpolator<T>> interps) {
+        return add_track(std::span(interps.begin(), interps.size()));
+    }
+
+    // builds a track one segment at a time, for values without a C++ type
+    void begin_track(std::uint32_t components);
+    void add_segment(std::span<const float> start, std::span<const float> end, Ticks duration, std::uint32_t easing);
+    std::uint32_t end_track();
+
+    // same, duration in seconds
+    void add_segment(std::span<const float> start, std::span<const float> end, double duration, std::uint32_t easing) {
+        add_segment(start, end, to_ticks(duration), easing);
+    }
+
+    std::uint32_t add_batch(std::span<const std::uint32_t> children);
+    std::uint32_t add_sequence(std::span<const std::uint32_t> children);
+
+    // defaults to the first node
+    void set_root(std::uint32_t node);
+
+    [[nodiscard]] std::size_t get_size() const;
+    [[nodiscard]] std::vector<std::byte> finish() const;
+    [[nodiscard]] bool write(char const* path) const;
+
+private:
+    std::uint32_t add_node(NodeKind kind, std::span<const std::uint32_t> children);
+    [[nodiscard]] Header get_header() const;
+
+};
+
+// a compiled timeline, read in place
+// open() only checks the header and the section bounds, verify() also checks
+// every index and should be used on files that are not trusted
+class View {
+    Header const* m_header = nullptr;
+    Track const* m_tracks = nullptr;
+    Segment const* m_segments = nullptr;
+    float const* m_values = nullptr;
+    Node const* m_nodes = nullptr;
+    std::uint32_t const* m_children = nullptr;
+
+public:
+    // data must be aligned to 8 bytes and outlive the view
+    [[nodiscard]] static std::optional<View> open(std::span<const std::byte> data);
+
+    [[nodiscard]] bool verify() const;
+
+    [[nodiscard]] std::span<const Track> get_tracks() const {
+        return { m_tracks, m_header->track_count };
+    }
+
+    [[nodiscard]] std::span<const Node> get_nodes() const {
+        return { m_nodes, m_header->node_count };
+    }
+
+    [[nodiscard]] std::uint32_t get_root() const {
+        return m_header->root;
+    }
+
+    [[nodiscard]] std::span<const Segment> get_segments(std::uint32_t track) const {
+        Track const& t = m_tracks[track];
+        return { m_segments + t.first_segment, t.segment_count };
+    }
+
+    [[nodiscard]] std::span<const std::uint32_t> get_children(std::uint32_t node) const {
+        Node const& n = m_nodes[node];
+        if (n.kind == NodeKind::Track) return { };
+        return { m_children + n.index, n.count };
+    }
+
+    // longest child for batches, sum of the children for sequences
+    [[nodiscard]] Ticks get_duration_ticks(std::uint32_t node) const;
+
+    // same, in seconds
+    [[nodiscard]] double get_duration(std::uint32_t node) const {
+        return to_seconds(get_duration_ticks(node));
+    }
+
+    // evaluates a track with float components, out holds one float per component
+    void get(std::uint32_t track, Ticks t, std::span<float> out) const;
+
+    void get(std::uint32_t track, double t, std::span<float> out) const {
+        get(track, to_ticks(t), out);
+    }
+
+    // evaluates a track through lerp<T>
+    template <Decomposable T>
+    [[nodiscard]] T get(std::uint32_t track, double t) const {
+        return get<T>(track, to_ticks(t));
+    }
+
+    template <Decomposable T>
+    [[nodiscard]] T get(std::uint32_t track, Ticks t) const {
+        assert(m_tracks[track].components == Components<T>::count);
+
+        auto [segment, weight] = locate(track, t);
+        T start = detail::from_floats<T>(m_values + segment->first_value);
+        T end = detail::from_floats<T>(m_values + segment->first_value + Components<T>::count);
+        return anim::lerp(start, end, weight);
+    }
+
+private:
+    struct Location {
+        Segment const* segment;
+        float weight;
+    };
+
+    [[nodiscard]] Location locate(std::uint32_t track, Ticks t) const;
+
+};
+
+// plays a track of a compiled timeline
+template <Decomposable T>
+class TrackAnimation : public TimedAnimation {
+    View m_view;
+    std::uint32_t m_track;
+
+public:
+    TrackAnimation(View view, std::uint32_t track) : m_view(view), m_track(track) { }
+
+    [[nodiscard]] double get_duration() const override {
+        return to_seconds(get_duration_ticks());
+    }
+
+    [[nodiscard]] Ticks get_duration_ticks() const override {
+        return detail::from_file_time(m_view.get_tracks()[m_track].duration);
+    }
+
+    [[nodiscard]] T get() const {
+        ANIM_PROFILE_COUNT(AnimationGet);
+        return m_view.get<T>(m_track, get_elapsed_ticks().value_or(Ticks::zero()));
+    }
+
+    operator T() const {
+        return get();
+    }
+
+};
+
+// a read-only memory mapping of a whole file
+class MappedFile {
+    void* m_data = nullptr;
+    std::size_t m_size = 0;
+
+public:
+    MappedFile() = default;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+    ~MappedFile();
+
+    // returns false if the file cannot be mapped
+    [[nodiscard]] bool open(char const* path);
+    void close();
+
+    [[nodiscard]] std::span<const std::byte> get_data() const {
+        return { static_cast<std::byte const*>(m_data), m_size };
+    }
+
+};
+
+}
+
+}
@@ -0,0 +1,76 @@
+#include "commands.hh"
+
+#include <bit>
+#include <cassert>
+
+namespace anim {
+
+
+CommandQueue::CommandQueue(std::size_t capacity)
+: m_slots(std::make_unique<Slot[]>(capacity))
+, m_mask(capacity - 1)
+{
+    assert(capacity >= 2 && std::has_single_bit(capacity));
+
+    for (std::size_t i = 0; i < capacity; ++i)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool CommandQueue::push(Command const& command) {
+    std::size_t pos = m_tail.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    while (true) {
+        slot = &m_slots[pos & m_mask];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+
+        if (diff == 0) {
+            // the slot is free, claim it
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            // the consumer has not freed the slot of the previous lap yet
+            return false;
+        } else {
+            // another producer claimed it
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->command = command;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+std::optional<Command> CommandQueue::pop() {
+    Slot& slot = m_slots[m_head & m_mask];
+
+    if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+        return { };
+
+    Command command = slot.command;
+    slot.sequence.store(m_head + capacity(), std::memory_order_release);
+    m_head++;
+    return command;
+}
+
+std::size_t CommandQueue::drain() {
+    // only what was pushed before, so producers that keep pushing cannot
+    // hold the render thread here
+    std::size_t end = m_tail.load(std::memory_order_acquire);
+    std::size_t count = 0;
+
+    while (m_head < end) {
+        auto command = pop();
+        if (!command) break; // still being written, applied by the next drain()
+
+        command->apply(*command);
+        count++;
+    }
+
+    return count;
+}
+
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+
+#include "common.hh"
+#include "timed.hh"
+#include "animation.hh"
+
+// deferred animation control
+// producer threads push commands into a CommandQueue, and the render thread
+// applies them in one go at a fixed point of the frame, eg. before dispatching
+// sequences. Commands are stamped with the time they were issued at, so a start
+// or seek lands where it would have if it had been applied right away.
+
+namespace anim {
+
+struct Command {
+    using ApplyFn = void (*)(Command const& command);
+
+    ApplyFn apply = nullptr;
+    void* target = nullptr;
+    void* child = nullptr;
+    Ticks time { }; // get_time_ticks() when issued
+    Ticks value { };
+    alignas(std::max_align_t) std::array<std::byte, 64> payload { };
+};
+
+namespace commands {
+
+[[nodiscard]] inline Command start(IAnimation& anim) {
+    auto apply = [](Command const& command) {
+        static_cast<IAnimation*>(command.target)->start_at(command.time);
+    };
+    return { .apply = apply, .target = &anim, .time = get_time_ticks() };
+}
+
+// stops and rewinds the animation
+[[nodiscard]] inline Command reset(IAnimation& anim) {
+    auto apply = [](Command const& command) {
+        static_cast<IAnimation*>(command.target)->reset();
+    };
+    return { .apply = apply, .target = &anim, .time = get_time_ticks() };
+}
+
+[[nodiscard]] inline Command seek(TimedAnimation& anim, Ticks t) {
+    auto apply = [](Command const& command) {
+        static_cast<TimedAnimation*>(command.target)->seek(command.value, command.time);
+    };
+    return { .apply = apply, .target = &anim, .time = get_time_ticks(), .value = t };
+}
+
+// t in seconds
+[[nodiscard]] inline Command seek(TimedAnimation& anim, double t) {
+    return seek(anim, to_ticks(t));
+}
+
+template <Interpolatable T>
+[[nodiscard]] Command retarget(Animation<T>& anim, T end) {
+    static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(Command::payload),
+                  "retarget values are stored inline");
+
+    auto apply = [](Command const& command) {
+        T end;
+        std::memcpy(&end, command.payload.data(), sizeof(T));
+        static_cast<Animation<T>*>(command.target)->retarget(end);
+    };
+
+    Command command { .apply = apply, .target = &anim, .time = get_time_ticks() };
+    std::memcpy(command.payload.data(), &end, sizeof(T));
+    return command;
+}
+
+// adds a child to a Batch or a Sequence
+template <typename Container> requires requires (Container& c, IAnimation& a) { c.add(a); }
+[[nodiscard]] Command add(Container& container, IAnimation& child) {
+    auto apply = [](Command const& command) {
+        static_cast<Container*>(command.target)->add(*static_cast<IAnimation*>(command.child));
+    };
+    return { .apply = apply, .target = &container, .child = &child, .time = get_time_ticks() };
+}
+
+}
+
+// bounded lock-free queue with any number of producers and a single consumer
+// every slot carries a sequence number that tells producers and the consumer
+// whose turn it is, so neither side ever waits on a lock
+class CommandQueue {
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Command command;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask;
+
+    // on separate cache lines, as producers and the consumer write them concurrently
+    alignas(64) std::atomic<std::size_t> m_tail = 0;
+    alignas(64) std::size_t m_head = 0;
+
+public:
+    // capacity must be a power of two
+    explicit CommandQueue(std::size_t capacity = 1024);
+
+    // may be called from any thread, returns false if the queue is full
+    [[nodiscard]] bool push(Command const& command);
+
+    // render thread only
+    [[nodiscard]] std::optional<Command> pop();
+
+    // render thread only, applies the commands pushed before the call, in the
+    // order they were pushed, and returns how many were applied
+    // commands pushed meanwhile are left for the next call
+    std::size_t drain();
+
+    [[nodiscard]] std::size_t capacity() const {
+        return m_mask + 1;
+    }
+
+};
+
+}
@@ -1,9 +1,16 @@
 #pragma once
 
 #include <type_traits>
+#include <array>
+#include <utility>
 #include <functional>
+#include <typeinfo>
 
 #include "interpolators.hh"
+#include "components.hh"
+#include "ticks.hh"
+#include "profile.hh"
+#include "trace.hh"
 
 namespace anim {
 
@@ -15,17 +22,60 @@ template <typename T> requires std::is_arithmetic_v<T>
     return start + x * (end - start);
 }
 
+namespace detail {
+
+template <typename T>
+constexpr bool is_arithmetic_array = false;
+
+template <typename E, std::size_t N>
+constexpr bool is_arithmetic_array<std::array<E, N>> = std::is_arithmetic_v<E>;
+
+}
+
+// element-wise, written as a flat loop so it vectorizes
+template <typename T> requires detail::is_arithmetic_array<T>
+[[nodiscard]] inline constexpr T lerp(T start, T end, float x) {
+    T result { };
+    for (std::size_t i = 0; i < result.size(); ++i)
+        result[i] = anim::lerp(start[i], end[i], x);
+    return result;
+}
+
+// opt-in member-wise lerp for aggregates of arithmetic members (see components.hh):
+// template <> inline constexpr bool anim::enable_component_lerp<MyType> = true;
+template <typename T>
+constexpr bool enable_component_lerp = false;
+
+template <typename T> requires enable_component_lerp<T>
+[[nodiscard]] inline constexpr T lerp(T start, T end, float x) {
+    if constexpr (Decomposable<T>) {
+        // all members share one type, so lerp them as one array
+        using C = Components<T>;
+        return C::from_array(anim::lerp(C::to_array(start), C::to_array(end), x));
+
+    } else {
+        auto starts = tie_members(start);
+        auto ends = tie_members(end);
+
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return T { anim::lerp(std::get<Is>(starts), std::get<Is>(ends), x)... };
+        }(std::make_index_sequence<member_count<T>>());
+    }
+}
+
 
 
 #ifdef ANIM_INTEGRATION_RAYLIB
 
+// not constexpr where they call into raylib, which gcc rejects
+
 template <>
-[[nodiscard]] inline constexpr Vector2 lerp(Vector2 start, Vector2 end, float x) {
+[[nodiscard]] inline Vector2 lerp(Vector2 start, Vector2 end, float x) {
     return Vector2Lerp(start, end, x);
 }
 
 template <>
-[[nodiscard]] inline constexpr Color lerp(Color start, Color end, float x) {
+[[nodiscard]] inline Color lerp(Color start, Color end, float x) {
     return ColorLerp(start, end, x);
 }
 
@@ -39,6 +89,38 @@ template <>
     };
 }
 
+template <>
+[[nodiscard]] inline Vector3 lerp(Vector3 start, Vector3 end, float x) {
+    return Vector3Lerp(start, end, x);
+}
+
+// raylib aliases Quaternion to Vector4, so all Vector4s are treated as rotations
+template <>
+[[nodiscard]] inline Quaternion lerp(Quaternion start, Quaternion end, float x) {
+    return QuaternionSlerp(start, end, x);
+}
+
+// interpolates translation, rotation and scale separately, so rotations
+// don't shear or shrink the way a component-wise blend would
+template <>
+[[nodiscard]] inline Matrix lerp(Matrix start, Matrix end, float x) {
+    Vector3 start_translation, end_translation, start_scale, end_scale;
+    Quaternion start_rotation, end_rotation;
+
+    MatrixDecompose(start, &start_translation, &start_rotation, &start_scale);
+    MatrixDecompose(end, &end_translation, &end_rotation, &end_scale);
+
+    Vector3 translation = Vector3Lerp(start_translation, end_translation, x);
+    Quaternion rotation = QuaternionSlerp(start_rotation, end_rotation, x);
+    Vector3 scale = Vector3Lerp(start_scale, end_scale, x);
+
+    // the inverse of MatrixDecompose(), which splits off the scale after the rotation
+    return MatrixMultiply(
+        MatrixMultiply(QuaternionToMatrix(rotation), MatrixScale(scale.x, scale.y, scale.z)),
+        MatrixTranslate(translation.x, translation.y, translation.z)
+    );
+}
+
 #endif // ANIM_INTEGRATION_RAYLIB
 
 
@@ -54,23 +136,30 @@ concept Interpolatable = requires (T start, T end, float x) {
 // a transition between two values
 template <Interpolatable T>
 class Interpolator {
-    using InterpFn = std::function<float(float)>;
+    // a plain function pointer instead of std::function, so copying an
+    // interpolator never allocates (captureless lambdas still convert)
+    using InterpFn = float (*)(float);
 
     const T m_start;
     const T m_end;
-    const double m_duration;
+    const Ticks m_duration;
     const InterpFn m_fn;
 
 public:
-    Interpolator() : Interpolator(1.0f) { }
-    explicit Interpolator(T end) : Interpolator(0.0f, end) { }
-    Interpolator(T start, T end) : Interpolator(start, end, 1.0f) { }
+    constexpr Interpolator() : Interpolator(1.0f) { }
+    constexpr explicit Interpolator(T end) : Interpolator(0.0f, end) { }
+    constexpr Interpolator(T start, T end) : Interpolator(start, end, 1.0f) { }
 
-    Interpolator(T start, T end, double duration)
-    : Interpolator(start, end, duration, [](float x) { return x; })
+    constexpr Interpolator(T start, T end, double duration)
+    : Interpolator(start, end, duration, interpolators::linear)
     { }
 
-    Interpolator(T start, T end, double duration, InterpFn fn)
+    // duration in seconds
+    constexpr Interpolator(T start, T end, double duration, InterpFn fn)
+    : Interpolator(start, end, to_ticks(duration), fn)
+    { }
+
+    constexpr Interpolator(T start, T end, Ticks duration, InterpFn fn = interpolators::linear)
         : m_start(start)
         , m_end(end)
         , m_duration(duration)
@@ -82,25 +171,43 @@ public:
         return Interpolator(value, value, duration, interpolators::step);
     }
 
-    [[nodiscard]] T get_start() const {
+    [[nodiscard]] constexpr T get_start() const {
         return m_start;
     }
 
-    [[nodiscard]] T get_end() const {
+    [[nodiscard]] constexpr T get_end() const {
         return m_end;
     }
 
-    [[nodiscard]] double get_duration() const {
+    // in seconds
+    [[nodiscard]] constexpr double get_duration() const {
+        return to_seconds(m_duration);
+    }
+
+    [[nodiscard]] constexpr Ticks get_duration_ticks() const {
         return m_duration;
     }
 
+    [[nodiscard]] constexpr InterpFn get_fn() const {
+        return m_fn;
+    }
+
     operator T() const {
         return get();
     }
 
-    [[nodiscard]] T get(double t) const {
-        double x = t / m_duration;
-        return anim::lerp(m_start, m_end, m_fn(x));
+    // t since the start of the interpolator, the only place where time turns into a float
+    [[nodiscard]] constexpr T get(Ticks t) const {
+        if !consteval {
+            ANIM_PROFILE_COUNT(EasingEval);
+        }
+        double x = static_cast<double>(t.count()) / static_cast<double>(m_duration.count());
+        return anim::lerp(m_start, m_end, m_fn(static_cast<float>(x)));
+    }
+
+    // same, t in seconds
+    [[nodiscard]] constexpr T get(double t) const {
+        return get(to_ticks(t));
     }
 
 };
@@ -109,8 +216,13 @@ public:
 struct IAnimation {
     virtual void start() = 0;
     virtual void reset() = 0;
+    // starts as if start() had been called at the given time of get_time_ticks()
+    // animations without a clock of their own just start now
+    virtual void start_at([[maybe_unused]] Ticks time) { start(); }
     [[nodiscard]] virtual double get_progress() const = 0; // 0..1
-    [[nodiscard]] virtual double get_duration() const = 0;
+    [[nodiscard]] virtual double get_duration() const = 0; // in seconds
+    // exact, animations that keep their duration in ticks override this
+    [[nodiscard]] virtual Ticks get_duration_ticks() const { return to_ticks(get_duration()); }
     [[nodiscard]] virtual bool is_stopped() const = 0;
     [[nodiscard]] virtual bool is_done() const = 0;
     [[nodiscard]] virtual bool is_running() const = 0;
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <bit>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+// member-wise access to simple aggregates, eg. struct { float x, y, z; }
+// members are found via aggregate initialization and structured bindings,
+// so this only works for aggregates of up to 16 arithmetic members,
+// without base classes, nested aggregates or arrays
+
+namespace anim {
+
+namespace detail {
+
+struct AnyMember {
+    template <typename U>
+    constexpr operator U() const noexcept;
+};
+
+template <typename T, std::size_t... Is>
+[[nodiscard]] consteval bool is_brace_constructible(std::index_sequence<Is...>) {
+    return requires { T { (void(Is), AnyMember { })... }; };
+}
+
+template <typename T, std::size_t N = 16>
+[[nodiscard]] consteval std::size_t count_members() {
+    if constexpr (N == 0)
+        return 0;
+    else if constexpr (is_brace_constructible<T>(std::make_index_sequence<N>()))
+        return N;
+    else
+        return count_members<T, N - 1>();
+}
+
+}
+
+template <typename T>
+constexpr std::size_t member_count = std::is_aggregate_v<T> ? detail::count_members<T>() : 0;
+
+// references to all members of value, in declaration order
+template <typename T>
+[[nodiscard]] constexpr auto tie_members(T& value) {
+    constexpr std::size_t N = member_count<std::remove_const_t<T>>;
+    static_assert(N > 0 && N <= 16, "not a supported aggregate");
+
+    if constexpr (N == 1) {
+        auto& [m0] = value;
+        return std::tie(m0);
+    } else if constexpr (N == 2) {
+        auto& [m0, m1] = value;
+        return std::tie(m0, m1);
+    } else if constexpr (N == 3) {
+        auto& [m0, m1, m2] = value;
+        return std::tie(m0, m1, m2);
+    } else if constexpr (N == 4) {
+        auto& [m0, m1, m2, m3] = value;
+        return std::tie(m0, m1, m2, m3);
+    } else if constexpr (N == 5) {
+        auto& [m0, m1, m2, m3, m4] = value;
+        return std::tie(m0, m1, m2, m3, m4);
+    } else if constexpr (N == 6) {
+        auto& [m0, m1, m2, m3, m4, m5] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5);
+    } else if constexpr (N == 7) {
+        auto& [m0, m1, m2, m3, m4, m5, m6] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6);
+    } else if constexpr (N == 8) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7);
+    } else if constexpr (N == 9) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8);
+    } else if constexpr (N == 10) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9);
+    } else if constexpr (N == 11) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10);
+    } else if constexpr (N == 12) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11);
+    } else if constexpr (N == 13) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12);
+    } else if constexpr (N == 14) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13);
+    } else if constexpr (N == 15) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14);
+    } else if constexpr (N == 16) {
+        auto& [m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15] = value;
+        return std::tie(m0, m1, m2, m3, m4, m5, m6, m7, m8, m9, m10, m11, m12, m13, m14, m15);
+    }
+}
+
+template <typename T>
+using member_types = decltype(tie_members(std::declval<T&>()));
+
+namespace detail {
+
+template <typename Tuple>
+struct HomogeneousArithmetic : std::false_type { };
+
+template <typename M, typename... Ms>
+struct HomogeneousArithmetic<std::tuple<M&, Ms&...>>
+    : std::bool_constant<std::is_arithmetic_v<M> && (std::is_same_v<M, Ms> && ...)> {
+    using value_type = M;
+};
+
+}
+
+// decomposes a value into an array of equally typed arithmetic components
+// available for arithmetic types, std::array and aggregates whose members
+// all share one arithmetic type without padding
+template <typename T>
+struct Components;
+
+template <typename T> requires std::is_arithmetic_v<T>
+struct Components<T> {
+    using value_type = T;
+    static constexpr std::size_t count = 1;
+
+    [[nodiscard]] static constexpr std::array<T, 1> to_array(T value) {
+        return { value };
+    }
+
+    [[nodiscard]] static constexpr T from_array(std::array<T, 1> array) {
+        return array[0];
+    }
+};
+
+template <typename E, std::size_t N> requires std::is_arithmetic_v<E>
+struct Components<std::array<E, N>> {
+    using value_type = E;
+    static constexpr std::size_t count = N;
+
+    [[nodiscard]] static constexpr std::array<E, N> to_array(std::array<E, N> value) {
+        return value;
+    }
+
+    [[nodiscard]] static constexpr std::array<E, N> from_array(std::array<E, N> array) {
+        return array;
+    }
+};
+
+template <typename T>
+    requires (!std::is_arithmetic_v<T>)
+          && std::is_trivially_copyable_v<T>
+          && (member_count<T> > 0)
+          && detail::HomogeneousArithmetic<member_types<T>>::value
+          && (sizeof(T) == member_count<T> * sizeof(typename detail::HomogeneousArithmetic<member_types<T>>::value_type))
+struct Components<T> {
+    using value_type = typename detail::HomogeneousArithmetic<member_types<T>>::value_type;
+    static constexpr std::size_t count = member_count<T>;
+
+    [[nodiscard]] static constexpr std::array<value_type, count> to_array(T value) {
+        return std::bit_cast<std::array<value_type, count>>(value);
+    }
+
+    [[nodiscard]] static constexpr T from_array(std::array<value_type, count> array) {
+        return std::bit_cast<T>(array);
+    }
+};
+
+template <typename T>
+concept Decomposable = requires { Components<T>::count; };
+
+}
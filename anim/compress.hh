@@ -0,0 +1,283 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+
+#include "common.hh"
+#include "components.hh"
+#include "spline.hh"
+
+// reduces densely sampled tracks, eg. motion capture at 120 Hz, to the few
+// keys that reproduce them within a tolerance
+//
+// fit_linear:  linear segments, for Animation<T>. For every segment, each
+//              component keeps the range of slopes that passes within the
+//              tolerance of all samples so far, and the segment ends when a
+//              range becomes empty. One pass over the samples, O(n).
+// fit_hermite: cubic hermite keys at a subset of the samples, with tangents
+//              from the neighbouring samples, for Spline<T>. Segments grow by
+//              doubling their length, then bisecting, while all samples they
+//              cover stay within the tolerance, O(n log n).
+//
+// Samples are given in time order, with times in seconds since the start of
+// the track. The tolerance applies to every component, on top of the rounding
+// of the result to T, which matters for float values far from zero. The
+// reported error is measured on the result at every sample.
+
+namespace anim {
+
+struct CompressionStats {
+    std::size_t samples = 0;
+    std::size_t keys = 0;
+    double max_error = 0.0f; // largest difference of a component at a sample
+
+    [[nodiscard]] double get_ratio() const {
+        return static_cast<double>(samples) / static_cast<double>(keys);
+    }
+};
+
+template <Interpolatable T>
+struct LinearFit {
+    std::vector<Interpolator<T>> interps; // eg. for Animation<T>
+    CompressionStats stats;
+};
+
+template <Decomposable T>
+struct HermiteFit {
+    Spline<T> spline;
+    CompressionStats stats;
+};
+
+namespace detail {
+
+template <Decomposable T>
+using Doubles = std::array<double, Components<T>::count>;
+
+template <Decomposable T>
+[[nodiscard]] Doubles<T> to_doubles(T const& value) {
+    auto components = Components<T>::to_array(value);
+    Doubles<T> out;
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = static_cast<double>(components[i]);
+    return out;
+}
+
+template <Decomposable T>
+[[nodiscard]] T from_doubles(Doubles<T> const& values) {
+    using C = Components<T>;
+    using V = typename C::value_type;
+
+    std::array<V, C::count> components;
+    for (std::size_t i = 0; i < C::count; ++i) {
+        if constexpr (std::is_integral_v<V>)
+            components[i] = static_cast<V>(std::clamp(std::round(values[i]),
+                                                      static_cast<double>(std::numeric_limits<V>::lowest()),
+                                                      static_cast<double>(std::numeric_limits<V>::max())));
+        else
+            components[i] = static_cast<V>(values[i]);
+    }
+    return C::from_array(components);
+}
+
+template <Decomposable T>
+[[nodiscard]] double get_error(T const& a, T const& b) {
+    auto x = to_doubles(a);
+    auto y = to_doubles(b);
+    double error = 0;
+    for (std::size_t i = 0; i < x.size(); ++i)
+        error = std::max(error, std::abs(x[i] - y[i]));
+    return error;
+}
+
+}
+
+template <typename T> requires Interpolatable<T> && Decomposable<T>
+[[nodiscard]] LinearFit<T> fit_linear(std::span<const typename Spline<T>::Key> samples, double tolerance) {
+    static constexpr std::size_t N = Components<T>::count;
+    static constexpr double inf = std::numeric_limits<double>::infinity();
+    using Vector = detail::Doubles<T>;
+
+    assert(samples.size() >= 2 && "nothing to compress");
+
+    LinearFit<T> fit;
+    fit.stats.samples = samples.size();
+
+    double anchor_time = samples.front().time;
+    Vector anchor = detail::to_doubles(samples.front().value);
+    T anchor_value = samples.front().value;
+    std::array<double, N> lo, hi;
+    lo.fill(-inf);
+    hi.fill(inf);
+
+    // a track that starts late holds its first value until then
+    if (anchor_time > 0)
+        fit.interps.push_back(Interpolator<T>::wait(anchor_value, anchor_time));
+
+    // ends the segment at the given time, on the middle of the slope ranges
+    auto emit = [&](double time) {
+        Vector end;
+        for (std::size_t c = 0; c < N; ++c)
+            end[c] = anchor[c] + (lo[c] + hi[c]) / 2 * (time - anchor_time);
+
+        T end_value = detail::from_doubles<T>(end);
+        Ticks duration = to_ticks(time) - to_ticks(anchor_time);
+        fit.interps.emplace_back(anchor_value, end_value, duration, interpolators::linear);
+
+        anchor_time = time;
+        anchor = end;
+        anchor_value = end_value;
+        lo.fill(-inf);
+        hi.fill(inf);
+    };
+
+    for (std::size_t i = 1; i < samples.size(); ++i) {
+        Vector value = detail::to_doubles(samples[i].value);
+
+        // a single sample always fits, so this runs at most twice
+        while (true) {
+            double dt = samples[i].time - anchor_time;
+            assert(dt > 0 && "sample times must increase");
+
+            std::array<double, N> new_lo, new_hi;
+            bool fits = true;
+            for (std::size_t c = 0; c < N; ++c) {
+                new_lo[c] = std::max(lo[c], (value[c] - tolerance - anchor[c]) / dt);
+                new_hi[c] = std::min(hi[c], (value[c] + tolerance - anchor[c]) / dt);
+                fits &= new_lo[c] <= new_hi[c];
+            }
+
+            if (fits) {
+                lo = new_lo;
+                hi = new_hi;
+                break;
+            }
+
+            emit(samples[i - 1].time);
+        }
+    }
+
+    emit(samples.back().time);
+
+    // measured on the interpolators, so rounding of T counts as well
+    std::size_t segment = 0;
+    Ticks start = Ticks::zero();
+    for (auto const& sample : samples) {
+        Ticks t = to_ticks(sample.time);
+        while (segment + 1 < fit.interps.size() && t > start + fit.interps[segment].get_duration_ticks()) {
+            start += fit.interps[segment].get_duration_ticks();
+            ++segment;
+        }
+
+        auto error = detail::get_error(fit.interps[segment].get(t - start), sample.value);
+        fit.stats.max_error = std::max(fit.stats.max_error, error);
+    }
+
+    fit.stats.keys = fit.interps.size() + 1;
+    return fit;
+}
+
+template <Decomposable T>
+[[nodiscard]] HermiteFit<T> fit_hermite(std::span<const typename Spline<T>::Key> samples, double tolerance) {
+    static constexpr std::size_t N = Components<T>::count;
+    using Vector = detail::Doubles<T>;
+
+    assert(samples.size() >= 2 && "nothing to compress");
+    std::size_t n = samples.size();
+
+    std::vector<Vector> values(n), tangents(n);
+    for (std::size_t i = 0; i < n; ++i)
+        values[i] = detail::to_doubles(samples[i].value);
+
+    // central differences, one-sided at the ends
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t prev = i == 0 ? 0 : i - 1;
+        std::size_t next = i == n - 1 ? n - 1 : i + 1;
+        double dt = samples[next].time - samples[prev].time;
+        for (std::size_t c = 0; c < N; ++c)
+            tangents[i][c] = (values[next][c] - values[prev][c]) / dt;
+    }
+
+    // whether a hermite segment from sample a to sample b passes all samples in between
+    auto fits = [&](std::size_t a, std::size_t b) {
+        double h = samples[b].time - samples[a].time;
+
+        for (std::size_t j = a + 1; j < b; ++j) {
+            double u = (samples[j].time - samples[a].time) / h;
+            double u2 = u * u, u3 = u2 * u;
+            double h00 = 2 * u3 - 3 * u2 + 1;
+            double h10 = (u3 - 2 * u2 + u) * h;
+            double h01 = -2 * u3 + 3 * u2;
+            double h11 = (u3 - u2) * h;
+
+            for (std::size_t c = 0; c < N; ++c) {
+                double p = h00 * values[a][c] + h10 * tangents[a][c] + h01 * values[b][c] + h11 * tangents[b][c];
+                if (std::abs(p - values[j][c]) > tolerance) return false;
+            }
+        }
+
+        return true;
+    };
+
+    std::vector<std::size_t> keys { 0 };
+    std::size_t last = n - 1;
+
+    for (std::size_t i = 0; i < last;) {
+        // lengths up to `length` fit, `limit` is the first that is known not to
+        std::size_t remaining = last - i;
+        std::size_t length = 1;
+        std::size_t limit = remaining + 1;
+
+        for (std::size_t probe = 2; probe <= remaining; probe *= 2) {
+            if (!fits(i, i + probe)) {
+                limit = probe;
+                break;
+            }
+            length = probe;
+        }
+
+        if (limit > remaining && length < remaining) {
+            if (fits(i, last)) length = remaining;
+            else limit = remaining;
+        }
+
+        while (limit - length > 1) {
+            std::size_t mid = length + (limit - length) / 2;
+            if (fits(i, i + mid)) length = mid;
+            else limit = mid;
+        }
+
+        i += length;
+        keys.push_back(i);
+    }
+
+    // tangents stay scalars, rounding them like the values would flatten
+    // every falling segment of an integer track
+    std::vector<typename Spline<T>::HermiteKey> hermite;
+    hermite.reserve(keys.size());
+    for (std::size_t key : keys) {
+        typename Spline<T>::Tangent tangent;
+        for (std::size_t c = 0; c < N; ++c)
+            tangent[c] = static_cast<typename Spline<T>::Tangent::value_type>(tangents[key][c]);
+        hermite.push_back({ samples[key].time, samples[key].value, tangent });
+    }
+
+    HermiteFit<T> fit { Spline<T>::hermite(hermite), { } };
+    fit.stats.samples = n;
+    fit.stats.keys = keys.size();
+
+    std::size_t cursor = 0;
+    for (auto const& sample : samples) {
+        auto error = detail::get_error(fit.spline.get(sample.time, cursor), sample.value);
+        fit.stats.max_error = std::max(fit.stats.max_error, error);
+    }
+
+    return fit;
+}
+
+}
@@ -0,0 +1,133 @@
+#include <mutex>
+#include <vector>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+#include <condition_variable>
+
+#include "crossfade.hh"
+#include "simd.hh"
+
+namespace anim {
+
+namespace {
+
+// worker threads that are kept between calls, so a call only wakes them
+// instead of starting threads and allocating every frame
+class WorkerPool {
+    using Job = void (*)(void const* context, std::size_t part);
+
+    std::mutex m_running; // one job at a time
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_finished;
+
+    Job m_job = nullptr;
+    void const* m_context = nullptr;
+    std::size_t m_next = 0; // next part to take
+    std::size_t m_parts = 0;
+    std::size_t m_pending = 0; // parts taken by workers that did not finish yet
+    bool m_stopping = false;
+
+    std::vector<std::jthread> m_workers; // last, so they are joined first
+
+public:
+    ~WorkerPool() {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+    }
+
+    // calls fn(part) for each part in 0..parts, part 0 on the calling thread
+    // starts workers only if there are fewer than parts - 1 yet
+    template <typename Fn>
+    void run(std::size_t parts, Fn const& fn) {
+        std::scoped_lock running(m_running);
+
+        {
+            std::scoped_lock lock(m_mutex);
+            while (m_workers.size() + 1 < parts)
+                m_workers.emplace_back([this] { work(); });
+
+            m_job = [](void const* context, std::size_t part) { (*static_cast<Fn const*>(context))(part); };
+            m_context = &fn;
+            m_next = 1;
+            m_parts = parts;
+            m_pending = parts - 1;
+        }
+
+        m_wake.notify_all();
+        fn(0);
+
+        std::unique_lock lock(m_mutex);
+        m_finished.wait(lock, [&] { return m_pending == 0; });
+    }
+
+private:
+    void work() {
+        std::unique_lock lock(m_mutex);
+
+        while (true) {
+            m_wake.wait(lock, [&] { return m_stopping || m_next < m_parts; });
+            if (m_stopping) return;
+
+            std::size_t part = m_next++;
+            lock.unlock();
+            m_job(m_context, part);
+            lock.lock();
+
+            if (--m_pending == 0)
+                m_finished.notify_one();
+        }
+    }
+
+};
+
+WorkerPool& get_pool() {
+    static WorkerPool pool;
+    return pool;
+}
+
+}
+
+void crossfade(std::span<const std::uint8_t> a, std::span<const std::uint8_t> b,
+               float x, std::span<std::uint8_t> out, unsigned threads) {
+    assert(a.size() == out.size() && b.size() == out.size());
+
+    std::uint32_t weight = simd::to_fixed_weight(x);
+
+    auto blend = [&](std::size_t first, std::size_t count) {
+        simd::lerp_bytes(a.data() + first, b.data() + first, weight, out.data() + first, count);
+    };
+
+    // small buffers are not worth waking the workers
+    constexpr std::size_t min_chunk = 256 * 1024;
+    std::size_t max_threads = std::max<std::size_t>(1, out.size() / min_chunk);
+    std::size_t count = std::clamp<std::size_t>(threads, 1, max_threads);
+
+    if (count == 1) {
+        blend(0, out.size());
+        return;
+    }
+
+    // chunks start at 64 byte aligned addresses, so no two threads share a
+    // cache line of out, the last one ends with the buffer
+    auto base = reinterpret_cast<std::uintptr_t>(out.data());
+    std::size_t chunk = (out.size() + count - 1) / count;
+
+    auto boundary = [&](std::size_t i) {
+        if (i == 0) return std::size_t(0);
+        std::uintptr_t aligned = (base + i * chunk + 63) & ~std::uintptr_t(63);
+        return std::min<std::size_t>(aligned - base, out.size());
+    };
+
+    get_pool().run(count, [&](std::size_t i) {
+        std::size_t first = boundary(i);
+        std::size_t last = i + 1 == count ? out.size() : boundary(i + 1);
+        if (first < last) blend(first, last - first);
+    });
+}
+
+}
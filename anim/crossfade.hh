@@ -0,0 +1,59 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+#include <cassert>
+
+#include "common.hh"
+#include "animation.hh"
+
+namespace anim {
+
+// blends two pixel buffers of 8-bit channels into out, with one weight
+// for the whole buffer: out = a * (1 - x) + b * x
+// uses 8-bit fixed point and splits the buffer across `threads` threads,
+// which are kept between calls, only the first call that needs more of them
+// starts threads (threads > 1 requires thread support, eg. -pthread for emscripten)
+void crossfade(std::span<const std::uint8_t> a, std::span<const std::uint8_t> b,
+               float x, std::span<std::uint8_t> out, unsigned threads = 1);
+
+#ifdef ANIM_INTEGRATION_RAYLIB
+
+inline void crossfade(std::span<const Color> a, std::span<const Color> b,
+                      float x, std::span<Color> out, unsigned threads = 1) {
+    static_assert(sizeof(Color) == 4);
+    crossfade(std::span(reinterpret_cast<std::uint8_t const*>(a.data()), a.size_bytes()),
+              std::span(reinterpret_cast<std::uint8_t const*>(b.data()), b.size_bytes()),
+              x,
+              std::span(reinterpret_cast<std::uint8_t*>(out.data()), out.size_bytes()),
+              threads);
+}
+
+inline void crossfade(std::span<const Color> a, std::span<const Color> b,
+                      Animation<float> const& x, std::span<Color> out, unsigned threads = 1) {
+    crossfade(a, b, x.get(), out, threads);
+}
+
+// all images need the same size and the PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 format
+inline void crossfade(Image const& a, Image const& b, float x, Image& out, unsigned threads = 1) {
+    assert(a.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    assert(a.format == b.format && a.format == out.format);
+    assert(a.width == b.width && a.width == out.width);
+    assert(a.height == b.height && a.height == out.height);
+
+    auto size = static_cast<std::size_t>(a.width) * static_cast<std::size_t>(a.height) * 4;
+    crossfade(std::span(static_cast<std::uint8_t const*>(a.data), size),
+              std::span(static_cast<std::uint8_t const*>(b.data), size),
+              x,
+              std::span(static_cast<std::uint8_t*>(out.data), size),
+              threads);
+}
+
+inline void crossfade(Image const& a, Image const& b, Animation<float> const& x,
+                      Image& out, unsigned threads = 1) {
+    crossfade(a, b, x.get(), out, threads);
+}
+
+#endif // ANIM_INTEGRATION_RAYLIB
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+
+#include "common.hh"
+#include "simd.hh"
+#include "timed.hh"
+
+namespace anim {
+
+// many instances of one keyframe shape
+// the shape is a list of interpolators over a weight, usually going from 0 to 1,
+// that is shared by all instances. Each instance maps the weight onto its own
+// start and end value, and may be delayed by an offset and stretched by a scale.
+// Instances are stored as parallel arrays, so adding them never allocates per
+// instance and evaluating all of them is a single pass.
+template <Interpolatable T>
+class InstancedTrack : public TimedAnimation {
+    std::vector<Interpolator<float>> m_shape;
+    std::vector<double> m_shape_ends;
+
+    std::vector<T> m_starts;
+    std::vector<T> m_ends;
+    std::vector<double> m_offsets;
+    std::vector<double> m_inv_scales;
+    double m_duration = 0.0f;
+
+    mutable std::vector<float> m_weights; // scratch space for get(std::span<T>)
+
+public:
+    InstancedTrack(std::initializer_list<Interpolator<float>> shape)
+    : m_shape(shape)
+    {
+        assert(!m_shape.empty());
+
+        double time = 0.0f;
+        for (auto const& interp : m_shape) {
+            time += interp.get_duration();
+            m_shape_ends.push_back(time);
+        }
+    }
+
+    void reserve(std::size_t count) {
+        m_starts.reserve(count);
+        m_ends.reserve(count);
+        m_offsets.reserve(count);
+        m_inv_scales.reserve(count);
+        m_weights.reserve(count);
+    }
+
+    // adds an instance that starts after `offset` seconds and plays
+    // the shape `scale` times slower, returns its index
+    std::size_t add(T start, T end, double offset = 0.0f, double scale = 1.0f) {
+        assert(scale > 0.0f);
+
+        m_starts.push_back(start);
+        m_ends.push_back(end);
+        m_offsets.push_back(offset);
+        m_inv_scales.push_back(1.0f / scale);
+        m_weights.push_back(0.0f);
+
+        m_duration = std::max(m_duration, offset + get_shape_duration() * scale);
+        return m_starts.size() - 1;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_starts.size();
+    }
+
+    [[nodiscard]] double get_shape_duration() const {
+        return m_shape_ends.back();
+    }
+
+    [[nodiscard]] double get_duration() const override {
+        ANIM_PROFILE_COUNT(AnimationDuration);
+        return m_duration;
+    }
+
+    [[nodiscard]] T get(std::size_t index) const {
+        ANIM_PROFILE_COUNT(AnimationGet);
+        float weight = get_weight(index, get_local_time());
+        return anim::lerp(m_starts[index], m_ends[index], weight);
+    }
+
+    // evaluates every instance, reading the clock once, in a single lerp_n() call
+    void get(std::span<T> out) const {
+        ANIM_PROFILE_COUNT(AnimationGet);
+        assert(out.size() == size());
+
+        double t = get_local_time();
+
+        for (std::size_t i = 0; i < size(); ++i)
+            m_weights[i] = get_weight(i, t);
+
+        anim::lerp_n<T>(m_starts, m_ends, m_weights, out);
+    }
+
+private:
+    // time since start(), or 0 if the track has not been started
+    [[nodiscard]] double get_local_time() const {
+        return get_elapsed().value_or(0.0f);
+    }
+
+    [[nodiscard]] float get_weight(std::size_t index, double t) const {
+        double shape_t = (t - m_offsets[index]) * m_inv_scales[index];
+
+        if (shape_t <= 0.0f)
+            return m_shape.front().get_start();
+
+        if (shape_t >= get_shape_duration())
+            return m_shape.back().get_end();
+
+        auto current = std::ranges::lower_bound(m_shape_ends, shape_t);
+        auto segment = static_cast<std::size_t>(current - m_shape_ends.begin());
+        double segment_start = segment == 0 ? 0.0f : m_shape_ends[segment - 1];
+
+        return m_shape[segment].get(shape_t - segment_start);
+    }
+
+};
+
+}
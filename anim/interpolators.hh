@@ -1,11 +1,30 @@
 #pragma once
 
 #include <cmath>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "bezier.hh"
 
 namespace anim {
 
 namespace interpolators {
 
+namespace detail {
+
+// integer powers, so polynomial curves stay usable in constant expressions
+template <int N>
+[[nodiscard]] inline constexpr float pow(float x) noexcept {
+    float result = 1.0f;
+    for (int i = 0; i < N; ++i)
+        result *= x;
+    return result;
+}
+
+}
+
 #define ANIM_IMPL_INTERP_FN(ident) \
     [[nodiscard]] inline constexpr float ident(float x) noexcept
 
@@ -19,15 +38,15 @@ ANIM_IMPL_INTERP_FN (linear) {
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_quad) {
-    return std::pow(x, 2);
+    return detail::pow<2>(x);
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_out_quad) {
-    return x < 0.5 ? 2 * x * x : 1 - std::pow(-2 * x + 2, 2) / 2;
+    return x < 0.5 ? 2 * x * x : 1 - detail::pow<2>(-2 * x + 2) / 2;
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_cubic) {
-    return std::pow(x, 3);
+    return detail::pow<3>(x);
 }
 
 ANIM_IMPL_INTERP_FN (ease_out_expo) {
@@ -35,7 +54,7 @@ ANIM_IMPL_INTERP_FN (ease_out_expo) {
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_out_cubic) {
-    return x < 0.5 ? 4 * std::pow(x, 3) : 1 - std::pow(-2 * x + 2, 3) / 2;
+    return x < 0.5 ? 4 * detail::pow<3>(x) : 1 - detail::pow<3>(-2 * x + 2) / 2;
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_out_back) {
@@ -43,18 +62,18 @@ ANIM_IMPL_INTERP_FN (ease_in_out_back) {
     float c2 = c1 * 1.525;
 
     return x < 0.5
-    ? (std::pow(2 * x, 2) * ((c2 + 1) * 2 * x - c2)) / 2
-    : (std::pow(2 * x - 2, 2) * ((c2 + 1) * (x * 2 - 2) + c2) + 2) / 2;
+    ? (detail::pow<2>(2 * x) * ((c2 + 1) * 2 * x - c2)) / 2
+    : (detail::pow<2>(2 * x - 2) * ((c2 + 1) * (x * 2 - 2) + c2) + 2) / 2;
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_out_circ) {
     return x < 0.5
-    ? (1 - std::sqrt(1 - std::pow(2 * x, 2))) / 2
-    : (std::sqrt(1 - std::pow(-2 * x + 2, 2)) + 1) / 2;
+    ? (1 - std::sqrt(1 - detail::pow<2>(2 * x))) / 2
+    : (std::sqrt(1 - detail::pow<2>(-2 * x + 2)) + 1) / 2;
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_out_quint) {
-    return x < 0.5 ? 16 * std::pow(x, 5) : 1 - std::pow(-2 * x + 2, 5) / 2;
+    return x < 0.5 ? 16 * detail::pow<5>(x) : 1 - detail::pow<5>(-2 * x + 2) / 2;
 }
 
 ANIM_IMPL_INTERP_FN (ease_out_elastic) {
@@ -69,7 +88,7 @@ ANIM_IMPL_INTERP_FN (ease_in_expo) {
 ANIM_IMPL_INTERP_FN (ease_out_back) {
     float c1 = 1.70158;
     float c3 = c1 + 1;
-    return 1 + c3 * std::pow(x - 1, 3) + c1 * std::pow(x - 1, 2);
+    return 1 + c3 * detail::pow<3>(x - 1) + c1 * detail::pow<2>(x - 1);
 }
 
 ANIM_IMPL_INTERP_FN (ease_in_out_expo) {
@@ -78,6 +97,63 @@ ANIM_IMPL_INTERP_FN (ease_in_out_expo) {
     : (2 - std::pow(2, -20 * x + 10)) / 2;
 }
 
+// the css timing functions
+ANIM_IMPL_INTERP_FN (ease) {
+    return cubic_bezier<0.25f, 0.1f, 0.25f, 1.0f>(x);
+}
+
+ANIM_IMPL_INTERP_FN (ease_in) {
+    return cubic_bezier<0.42f, 0.0f, 1.0f, 1.0f>(x);
+}
+
+ANIM_IMPL_INTERP_FN (ease_out) {
+    return cubic_bezier<0.0f, 0.0f, 0.58f, 1.0f>(x);
+}
+
+ANIM_IMPL_INTERP_FN (ease_in_out) {
+    return cubic_bezier<0.42f, 0.0f, 0.58f, 1.0f>(x);
+}
+
+struct Easing {
+    std::string_view name;
+    float (*fn)(float);
+};
+
+// the index of an easing is its id in serialized timelines,
+// so new easings may only be appended
+inline constexpr std::array<Easing, 18> easings = {{
+    { "step", step },
+    { "linear", linear },
+    { "ease_in_quad", ease_in_quad },
+    { "ease_in_out_quad", ease_in_out_quad },
+    { "ease_in_cubic", ease_in_cubic },
+    { "ease_out_expo", ease_out_expo },
+    { "ease_in_out_cubic", ease_in_out_cubic },
+    { "ease_in_out_back", ease_in_out_back },
+    { "ease_in_out_circ", ease_in_out_circ },
+    { "ease_in_out_quint", ease_in_out_quint },
+    { "ease_out_elastic", ease_out_elastic },
+    { "ease_in_expo", ease_in_expo },
+    { "ease_out_back", ease_out_back },
+    { "ease_in_out_expo", ease_in_out_expo },
+    { "ease", ease },
+    { "ease_in", ease_in },
+    { "ease_out", ease_out },
+    { "ease_in_out", ease_in_out },
+}};
+
+[[nodiscard]] inline std::optional<std::uint32_t> find_easing(float (*fn)(float)) {
+    for (std::uint32_t i = 0; i < easings.size(); ++i)
+        if (easings[i].fn == fn) return i;
+    return { };
+}
+
+[[nodiscard]] inline std::optional<std::uint32_t> find_easing(std::string_view name) {
+    for (std::uint32_t i = 0; i < easings.size(); ++i)
+        if (easings[i].name == name) return i;
+    return { };
+}
+
 }
 
 }
@@ -0,0 +1,63 @@
+#include <array>
+
+#include "profile.hh"
+
+namespace anim {
+
+namespace profile {
+
+namespace {
+
+constexpr auto counter_count = static_cast<std::size_t>(Counter::Count_);
+
+std::array<std::atomic<std::uint64_t>, counter_count> g_counters { };
+
+[[nodiscard]] Stats make_stats(auto load) {
+    auto get = [&](Counter counter) {
+        return load(g_counters[static_cast<std::size_t>(counter)]);
+    };
+
+    return {
+        .animation_get      = get(Counter::AnimationGet),
+        .animation_duration = get(Counter::AnimationDuration),
+        .batch_longest      = get(Counter::BatchLongest),
+        .sequence_dispatch  = get(Counter::SequenceDispatch),
+        .clock_reads        = get(Counter::ClockRead),
+        .easing_evals       = get(Counter::EasingEval),
+        .bytes_allocated    = get(Counter::BytesAllocated),
+    };
+}
+
+}
+
+namespace detail {
+
+std::atomic<TypeStats*> g_types = nullptr;
+
+}
+
+TypeStats::TypeStats(char const* name) : name(name) {
+    next = detail::g_types.load(std::memory_order_relaxed);
+    while (!detail::g_types.compare_exchange_weak(next, this, std::memory_order_release))
+        ;
+}
+
+void count(Counter counter, std::uint64_t n) {
+    g_counters[static_cast<std::size_t>(counter)].fetch_add(n, std::memory_order_relaxed);
+}
+
+[[nodiscard]] Stats frame() {
+    return make_stats([](std::atomic<std::uint64_t>& c) {
+        return c.exchange(0, std::memory_order_relaxed);
+    });
+}
+
+[[nodiscard]] Stats snapshot() {
+    return make_stats([](std::atomic<std::uint64_t>& c) {
+        return c.load(std::memory_order_relaxed);
+    });
+}
+
+}
+
+}
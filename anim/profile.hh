@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <typeinfo>
+
+// hot path instrumentation
+// counting is enabled by defining ANIM_PROFILE (see the PROFILE cmake option),
+// otherwise all ANIM_PROFILE_* macros expand to nothing
+
+namespace anim {
+
+namespace profile {
+
+enum class Counter : std::size_t {
+    AnimationGet,
+    AnimationDuration,
+    BatchLongest,
+    SequenceDispatch,
+    ClockRead,
+    EasingEval,
+    BytesAllocated,
+    Count_,
+};
+
+// counter values accumulated since the previous call to frame()
+struct Stats {
+    std::uint64_t animation_get = 0;
+    std::uint64_t animation_duration = 0;
+    std::uint64_t batch_longest = 0;
+    std::uint64_t sequence_dispatch = 0;
+    std::uint64_t clock_reads = 0;
+    std::uint64_t easing_evals = 0;
+    std::uint64_t bytes_allocated = 0;
+};
+
+// total bytes allocated by all animations of a single value type
+struct TypeStats {
+    char const* name;
+    std::atomic<std::uint64_t> bytes_allocated = 0;
+    TypeStats* next = nullptr;
+
+    explicit TypeStats(char const* name);
+};
+
+void count(Counter counter, std::uint64_t n = 1);
+
+// returns the counters since the last call and starts a new frame
+[[nodiscard]] Stats frame();
+
+// returns the counters of the current frame without resetting them
+[[nodiscard]] Stats snapshot();
+
+template <typename T>
+[[nodiscard]] TypeStats& type_stats() {
+    static TypeStats stats(typeid(T).name());
+    return stats;
+}
+
+namespace detail {
+
+extern std::atomic<TypeStats*> g_types;
+
+}
+
+// calls fn for the TypeStats of every animated type seen so far
+template <typename Fn>
+void for_each_type(Fn fn) {
+    for (auto* it = detail::g_types.load(std::memory_order_acquire); it != nullptr; it = it->next)
+        fn(static_cast<TypeStats const&>(*it));
+}
+
+template <typename T>
+void count_alloc(std::uint64_t bytes) {
+    type_stats<T>().bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+    count(Counter::BytesAllocated, bytes);
+}
+
+}
+
+}
+
+#ifdef ANIM_PROFILE
+
+#define ANIM_PROFILE_COUNT(counter) \
+    ::anim::profile::count(::anim::profile::Counter::counter)
+
+#define ANIM_PROFILE_ALLOC(type, bytes) \
+    ::anim::profile::count_alloc<type>(bytes)
+
+#else
+
+#define ANIM_PROFILE_COUNT(counter) ((void) 0)
+#define ANIM_PROFILE_ALLOC(type, bytes) ((void) 0)
+
+#endif // ANIM_PROFILE
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "common.hh"
+#include "components.hh"
+#include "timed.hh"
+#include "simd.hh"
+#include "spline.hh"
+
+// compact storage of long, linearly interpolated tracks, eg. baked or imported ones
+//
+// An Interpolator<float> takes 24 bytes per keyframe. Here, a key is one 16-bit
+// time delta plus 16 bits per component, so a float track needs 4 bytes per key
+// and stays in cache four to six times longer:
+//
+// Unorm16: values are quantized against the range of each component over the
+//          track, the error is at most 1 / 131070 of that range
+// Half:    ieee half floats, for tracks without a known range, with a relative
+//          error of at most 2^-11. Tracks with values beyond +-65504, the
+//          largest half float, fall back to Unorm16, see get_quantization()
+//
+// Key times are rounded to multiples of a per-track quantum, the shortest that
+// lets the longest gap between keys fit into 16 bits, eg. 128ns for keys at
+// 120 Hz, unless all key times are multiples of a longer one already. Keys
+// closer together than half a quantum may round onto the same time, playback
+// then jumps from the key before them straight to the last one.
+// get_max_error() is measured by playing the track back at the original key
+// times, so it includes the rounding of the times and such collapsed keys.
+// Every 64th key also stores its absolute time, so a lookup is a binary search
+// over those, then a scan of at most 63 deltas. Values are decoded with the
+// vector kernels of simd.hh. A lookup decodes the 2 * N components of both
+// keys of its segment as one run, which is vectorized from N = 2 on.
+
+namespace anim {
+
+enum class Quantization { Unorm16, Half };
+
+template <typename T>
+    requires Decomposable<T> && std::is_same_v<typename Components<T>::value_type, float>
+class QuantizedTrack {
+    using C = Components<T>;
+    static constexpr std::size_t N = C::count;
+    static constexpr std::size_t s_block = 64;
+    static constexpr float s_half_max = 65504;
+
+    using Vector = std::array<float, N>;
+
+public:
+    using Key = typename Spline<T>::Key;
+
+    // the key of the previous lookup, see get()
+    struct Cursor {
+        std::size_t key = 0;
+        std::int64_t time = 0; // of the key, in quanta
+    };
+
+private:
+    Quantization m_quantization;
+    Ticks m_first; // time of the first key
+    Ticks m_quantum;
+    std::int64_t m_length = 0; // time of the last key, in quanta
+    Vector m_scale { };
+    Vector m_offset { };
+    std::vector<std::uint16_t> m_deltas; // quanta since the previous key
+    std::vector<std::uint16_t> m_values; // N per key
+    std::vector<std::int64_t> m_blocks; // time of every s_block-th key, in quanta
+    double m_max_error = 0;
+
+public:
+    QuantizedTrack(std::span<const Key> keys, Quantization quantization = Quantization::Unorm16)
+        : m_quantization(quantization)
+    {
+        assert(keys.size() >= 2 && "a track needs at least two keys");
+        std::size_t n = keys.size();
+
+        m_first = to_ticks(keys.front().time);
+        std::int64_t longest = 0, divisor = 0;
+        for (std::size_t i = 1; i < n; ++i) {
+            assert(keys[i].time > keys[i - 1].time && "key times must increase");
+            longest = std::max(longest, (to_ticks(keys[i].time) - to_ticks(keys[i - 1].time)).count());
+            divisor = std::gcd(divisor, (to_ticks(keys[i].time) - m_first).count());
+        }
+
+        // one less than the limit, as rounding the key times may widen a gap by one
+        // keys on a coarse grid, eg. whole frames, keep their exact times
+        std::int64_t limit = std::numeric_limits<std::uint16_t>::max() - 1;
+        std::int64_t quantum = std::max<std::int64_t>((longest + limit - 1) / limit, 1);
+        m_quantum = Ticks(divisor >= quantum ? divisor : quantum);
+
+        m_deltas.reserve(n);
+        m_blocks.reserve(n / s_block + 1);
+        std::int64_t previous = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::int64_t offset = (to_ticks(keys[i].time) - m_first).count();
+            std::int64_t time = (offset + m_quantum.count() / 2) / m_quantum.count();
+
+            if (i % s_block == 0) m_blocks.push_back(time);
+            m_deltas.push_back(static_cast<std::uint16_t>(time - previous));
+            previous = time;
+        }
+        m_length = previous;
+
+        encode(keys);
+
+        ANIM_PROFILE_ALLOC(T, m_deltas.capacity() * sizeof(std::uint16_t)
+                              + m_values.capacity() * sizeof(std::uint16_t)
+                              + m_blocks.capacity() * sizeof(std::int64_t));
+    }
+
+    QuantizedTrack(std::initializer_list<Key> keys, Quantization quantization = Quantization::Unorm16)
+        : QuantizedTrack(std::span(keys.begin(), keys.size()), quantization)
+    { }
+
+    [[nodiscard]] Ticks get_duration_ticks() const {
+        return m_first + m_length * m_quantum;
+    }
+
+    // time of the last key, the track holds the first value until the first key
+    [[nodiscard]] double get_duration() const {
+        return to_seconds(get_duration_ticks());
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_deltas.size();
+    }
+
+    // Unorm16 if Half was requested, but values were out of its range
+    [[nodiscard]] Quantization get_quantization() const {
+        return m_quantization;
+    }
+
+    // resolution of the key times
+    [[nodiscard]] Ticks get_quantum() const {
+        return m_quantum;
+    }
+
+    // largest difference of a component between a key and the track at its
+    // time, see above
+    [[nodiscard]] double get_max_error() const {
+        return m_max_error;
+    }
+
+    // bytes of key data
+    [[nodiscard]] std::size_t get_memory() const {
+        return (m_deltas.size() + m_values.size()) * sizeof(std::uint16_t)
+            + m_blocks.size() * sizeof(std::int64_t);
+    }
+
+    [[nodiscard]] T get_start() const {
+        return C::from_array(decode_key(0));
+    }
+
+    [[nodiscard]] T get_end() const {
+        return C::from_array(decode_key(size() - 1));
+    }
+
+    // decoded values of all keys, eg. to convert the track back
+    void decode(std::span<T> out) const {
+        assert(out.size() == size());
+        std::vector<float> values(m_values.size());
+        decode_keys(m_values.data(), values.data(), size());
+
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            Vector value;
+            std::copy_n(values.begin() + i * N, N, value.begin());
+            out[i] = C::from_array(value);
+        }
+    }
+
+    // binary search for the key
+    [[nodiscard]] T get(Ticks t) const {
+        Cursor cursor { size(), 0 };
+        return get(t, cursor);
+    }
+
+    [[nodiscard]] T get(double t) const {
+        return get(to_ticks(t));
+    }
+
+    // cursor is the key of the previous lookup, so playback that moves
+    // forward finds its key in constant time, and only jumps search
+    [[nodiscard]] T get(Ticks t, Cursor& cursor) const {
+        Ticks offset = t - m_first;
+        if (offset <= Ticks::zero()) return get_start();
+
+        std::int64_t time = offset / m_quantum;
+        if (time >= m_length) return get_end();
+
+        if (cursor.key + 1 >= size() || time < cursor.time) {
+            cursor = find(time);
+        } else if (time >= cursor.time + m_deltas[cursor.key + 1]) {
+            std::int64_t next = cursor.time + m_deltas[cursor.key + 1];
+            if (cursor.key + 2 < size() && time < next + m_deltas[cursor.key + 2])
+                cursor = { cursor.key + 1, next };
+            else
+                cursor = find(time);
+        }
+
+        // both keys are adjacent, so their components are decoded as one run
+        std::array<float, N * 2> values;
+        decode_keys(&m_values[cursor.key * N], values.data(), 2);
+
+        Ticks start = cursor.time * m_quantum;
+        Ticks duration = m_deltas[cursor.key + 1] * m_quantum;
+        auto x = static_cast<float>(static_cast<double>((offset - start).count())
+                                    / static_cast<double>(duration.count()));
+
+        Vector out;
+        for (std::size_t c = 0; c < N; ++c)
+            out[c] = values[c] + x * (values[N + c] - values[c]);
+
+        return C::from_array(out);
+    }
+
+private:
+    void encode(std::span<const Key> keys) {
+        std::size_t n = keys.size();
+        m_values.reserve(n * N);
+
+        // out of range values would become infinite
+        if (m_quantization == Quantization::Half) {
+            bool in_range = std::ranges::all_of(keys, [](Key const& key) {
+                return std::ranges::all_of(C::to_array(key.value), [](float c) { return std::abs(c) <= s_half_max; });
+            });
+            if (!in_range) m_quantization = Quantization::Unorm16;
+        }
+
+        if (m_quantization == Quantization::Unorm16) {
+            Vector lo, hi;
+            lo.fill(std::numeric_limits<float>::infinity());
+            hi.fill(-std::numeric_limits<float>::infinity());
+            for (auto const& key : keys) {
+                auto value = C::to_array(key.value);
+                for (std::size_t c = 0; c < N; ++c) {
+                    lo[c] = std::min(lo[c], value[c]);
+                    hi[c] = std::max(hi[c], value[c]);
+                }
+            }
+
+            static constexpr double s_steps = std::numeric_limits<std::uint16_t>::max();
+            for (std::size_t c = 0; c < N; ++c) {
+                m_offset[c] = lo[c];
+                m_scale[c] = static_cast<float>((static_cast<double>(hi[c]) - lo[c]) / s_steps);
+            }
+
+            for (auto const& key : keys) {
+                auto value = C::to_array(key.value);
+                for (std::size_t c = 0; c < N; ++c) {
+                    double q = m_scale[c] > 0 ? (value[c] - m_offset[c]) / static_cast<double>(m_scale[c]) : 0;
+                    m_values.push_back(static_cast<std::uint16_t>(std::clamp(std::round(q), 0.0, s_steps)));
+                }
+            }
+
+        } else {
+            for (auto const& key : keys)
+                for (float component : C::to_array(key.value))
+                    m_values.push_back(simd::to_half(component));
+        }
+
+        // at the original key times, so that keys whose time moved, or that
+        // collapsed onto the next one, count as well
+        Cursor cursor { n, 0 };
+        for (auto const& key : keys) {
+            auto expected = C::to_array(key.value);
+            auto actual = C::to_array(get(to_ticks(key.time), cursor));
+            for (std::size_t c = 0; c < N; ++c)
+                m_max_error = std::max(m_max_error, std::abs(static_cast<double>(actual[c]) - expected[c]));
+        }
+    }
+
+    void decode_keys(std::uint16_t const* src, float* out, std::size_t count) const {
+        if (m_quantization == Quantization::Unorm16)
+            simd::unorm16_to_floats<N>(src, m_scale.data(), m_offset.data(), out, count);
+        else
+            simd::half_to_floats(src, out, count * N);
+    }
+
+    [[nodiscard]] Vector decode_key(std::size_t key) const {
+        Vector out;
+        decode_keys(&m_values[key * N], out.data(), 1);
+        return out;
+    }
+
+    // the key at or before time, which is within the track
+    [[nodiscard]] Cursor find(std::int64_t time) const {
+        auto block = std::ranges::upper_bound(m_blocks, time) - m_blocks.begin() - 1;
+        Cursor cursor { static_cast<std::size_t>(block) * s_block, m_blocks[block] };
+
+        while (cursor.time + m_deltas[cursor.key + 1] <= time)
+            cursor.time += m_deltas[++cursor.key];
+
+        return cursor;
+    }
+
+};
+
+// plays back a quantized track, which it owns
+// remembers the key of the last get(), so reads should come from one thread
+template <typename T>
+    requires Decomposable<T> && std::is_same_v<typename Components<T>::value_type, float>
+class QuantizedAnimation : public TimedAnimation {
+    QuantizedTrack<T> m_track;
+    mutable typename QuantizedTrack<T>::Cursor m_cursor;
+
+public:
+    QuantizedAnimation(QuantizedTrack<T> track) : m_track(std::move(track)) { }
+
+    [[nodiscard]] double get_duration() const override {
+        return m_track.get_duration();
+    }
+
+    [[nodiscard]] Ticks get_duration_ticks() const override {
+        return m_track.get_duration_ticks();
+    }
+
+    [[nodiscard]] QuantizedTrack<T> const& get_track() const {
+        return m_track;
+    }
+
+    [[nodiscard]] T get() const {
+        ANIM_PROFILE_COUNT(AnimationGet);
+
+        auto elapsed = get_elapsed_ticks();
+        if (!elapsed)
+            return m_track.get_start();
+
+        return m_track.get(*elapsed, m_cursor);
+    }
+
+    operator T() const {
+        return get();
+    }
+
+};
+
+}
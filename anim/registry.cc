@@ -0,0 +1,117 @@
+#include "registry.hh"
+
+#include <chrono>
+#include <cassert>
+#include <algorithm>
+
+#include "template.hh"
+
+namespace anim {
+
+namespace {
+
+[[nodiscard]] std::uint64_t now_ns() {
+    namespace chrono = std::chrono;
+    auto time = chrono::steady_clock::now().time_since_epoch();
+    return chrono::duration_cast<chrono::nanoseconds>(time).count();
+}
+
+}
+
+
+TemplateRegistry::~TemplateRegistry() {
+    for (auto& entry : m_entries)
+        entry.tmpl->m_registry = nullptr;
+}
+
+void TemplateRegistry::add(AnimationTemplate& tmpl, int priority) {
+    assert(tmpl.m_registry == nullptr && "template is already registered");
+
+    tmpl.m_registry = this;
+    tmpl.m_registry_index = m_entries.size();
+    m_entries.push_back({ .tmpl = &tmpl, .priority = priority, .order = m_order++ });
+
+    if (tmpl.is_running())
+        wake(tmpl);
+}
+
+void TemplateRegistry::remove(AnimationTemplate& tmpl) {
+    assert(tmpl.m_registry == this);
+    assert(!m_is_updating && "templates cannot be removed during update()");
+
+    std::size_t index = tmpl.m_registry_index;
+    std::erase(m_live, index);
+    std::erase(m_waking, index);
+
+    // move the last entry into the gap
+    std::size_t last = m_entries.size() - 1;
+    if (index != last) {
+        m_entries[index] = m_entries[last];
+        m_entries[index].tmpl->m_registry_index = index;
+        std::ranges::replace(m_live, last, index);
+        std::ranges::replace(m_waking, last, index);
+    }
+
+    m_entries.pop_back();
+    tmpl.m_registry = nullptr;
+}
+
+void TemplateRegistry::wake(AnimationTemplate& tmpl) {
+    assert(tmpl.m_registry == this);
+
+    std::size_t index = tmpl.m_registry_index;
+    if (m_entries[index].is_live) return;
+
+    m_entries[index].is_live = true;
+
+    if (m_is_updating)
+        m_waking.push_back(index);
+    else
+        insert_live(index);
+}
+
+void TemplateRegistry::update() {
+    m_frame++;
+    m_is_updating = true;
+
+    // updated in place, dropping templates that are no longer running
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_live.size(); ++i) {
+        std::size_t index = m_live[i];
+        Entry& entry = m_entries[index];
+
+        std::uint64_t start = now_ns();
+        entry.tmpl->update();
+        entry.last_ns = now_ns() - start;
+        entry.total_ns += entry.last_ns;
+        entry.updates++;
+        entry.last_frame = m_frame;
+
+        if (entry.tmpl->is_running())
+            m_live[kept++] = index;
+        else
+            entry.is_live = false;
+    }
+    m_live.resize(kept);
+
+    m_is_updating = false;
+
+    for (std::size_t index : m_waking)
+        insert_live(index);
+    m_waking.clear();
+}
+
+void TemplateRegistry::insert_live(std::size_t index) {
+    auto it = std::ranges::upper_bound(m_live, index, [&](std::size_t a, std::size_t b) { return is_before(a, b); });
+    m_live.insert(it, index);
+}
+
+bool TemplateRegistry::is_before(std::size_t a, std::size_t b) const {
+    Entry const& x = m_entries[a];
+    Entry const& y = m_entries[b];
+    if (x.priority != y.priority) return x.priority < y.priority;
+    return x.order < y.order;
+}
+
+
+}
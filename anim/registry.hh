@@ -0,0 +1,76 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace anim {
+
+class AnimationTemplate;
+
+// updates the templates that are live, in a fixed order
+// templates report to their registry when they start, and are dropped once
+// they stop running, so idle templates cost nothing per frame. Live templates
+// are updated by ascending priority, and in order of registration on ties.
+class TemplateRegistry {
+public:
+    struct Entry {
+        AnimationTemplate* tmpl;
+        int priority;
+        std::uint64_t order;
+        bool is_live = false;
+
+        // cost of the update() calls, in nanoseconds of the steady clock
+        std::uint64_t last_ns = 0; // in frame last_frame
+        std::uint64_t total_ns = 0;
+        std::uint64_t updates = 0;
+        std::uint64_t last_frame = 0;
+    };
+
+private:
+    std::vector<Entry> m_entries;
+    std::vector<std::size_t> m_live; // indices into m_entries, sorted by priority
+    std::vector<std::size_t> m_waking; // started during update(), merged afterwards
+    std::uint64_t m_order = 0;
+    std::uint64_t m_frame = 0;
+    bool m_is_updating = false;
+
+public:
+    TemplateRegistry() = default;
+    TemplateRegistry(TemplateRegistry const&) = delete;
+    TemplateRegistry& operator=(TemplateRegistry const&) = delete;
+    ~TemplateRegistry();
+
+    // lower priorities are updated first
+    // a template that is already running becomes live right away
+    void add(AnimationTemplate& tmpl, int priority = 0);
+    void remove(AnimationTemplate& tmpl);
+
+    // called by templates when they start
+    void wake(AnimationTemplate& tmpl);
+
+    // updates all live templates, and drops the ones that stopped running
+    void update();
+
+    // one entry per registered template, in no particular order
+    [[nodiscard]] std::span<Entry const> get_entries() const {
+        return m_entries;
+    }
+
+    [[nodiscard]] std::size_t get_live_count() const {
+        return m_live.size();
+    }
+
+    // number of update() calls so far
+    [[nodiscard]] std::uint64_t get_frame() const {
+        return m_frame;
+    }
+
+private:
+    void insert_live(std::size_t index);
+    [[nodiscard]] bool is_before(std::size_t a, std::size_t b) const;
+
+};
+
+}
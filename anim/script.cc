@@ -0,0 +1,261 @@
+#include "script.hh"
+
+#include <array>
+#include <memory>
+#include <cassert>
+#include <algorithm>
+
+namespace anim {
+
+namespace {
+
+// frames are carved out of larger blocks in size classes of 64 bytes,
+// frames above 1 KiB come from the global heap
+constexpr std::size_t frame_granularity = 64;
+constexpr std::size_t frame_classes = 16;
+constexpr std::size_t frame_block_size = 64 * 1024;
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+// blocks are never released, as freed frames are reused by later scripts
+struct FramePool {
+    std::array<FreeFrame*, frame_classes> free_lists { };
+    std::vector<std::unique_ptr<std::byte[]>> blocks;
+    std::byte* cursor = nullptr;
+    std::byte* end = nullptr;
+};
+
+thread_local FramePool frame_pool;
+
+[[nodiscard]] std::size_t get_frame_class(std::size_t size) {
+    return (size - 1) / frame_granularity;
+}
+
+}
+
+namespace detail {
+
+void* allocate_frame(std::size_t size) {
+    if (size > frame_granularity * frame_classes)
+        return ::operator new(size);
+
+    auto& pool = frame_pool;
+    std::size_t frame_class = get_frame_class(size);
+
+    if (FreeFrame* frame = pool.free_lists[frame_class]) {
+        pool.free_lists[frame_class] = frame->next;
+        return frame;
+    }
+
+    std::size_t bytes = (frame_class + 1) * frame_granularity;
+
+    if (pool.cursor == nullptr || pool.end - pool.cursor < static_cast<std::ptrdiff_t>(bytes)) {
+        ANIM_PROFILE_ALLOC(Script, frame_block_size);
+        auto& block = pool.blocks.emplace_back(std::make_unique<std::byte[]>(frame_block_size));
+        pool.cursor = block.get();
+        pool.end = pool.cursor + frame_block_size;
+    }
+
+    void* frame = pool.cursor;
+    pool.cursor += bytes;
+    return frame;
+}
+
+void free_frame(void* frame, std::size_t size) {
+    if (size > frame_granularity * frame_classes) {
+        ::operator delete(frame);
+        return;
+    }
+
+    auto& pool = frame_pool;
+    std::size_t frame_class = get_frame_class(size);
+
+    auto* node = static_cast<FreeFrame*>(frame);
+    node->next = pool.free_lists[frame_class];
+    pool.free_lists[frame_class] = node;
+}
+
+}
+
+Scheduler::Scheduler(double now, double resolution)
+: m_timers(now, resolution)
+, m_now(now)
+{ }
+
+Scheduler::~Scheduler() {
+    for (auto handle : m_spawned)
+        handle.destroy();
+
+    for (auto const& entry : m_entries)
+        if (entry.state != Entry::State::Free && entry.event.handle)
+            entry.event.handle.destroy();
+}
+
+void Scheduler::spawn(Script script) {
+    Script::Handle handle = std::exchange(script.m_handle, { });
+    handle.promise().scheduler = this;
+    m_spawned.push_back(handle);
+}
+
+Scheduler::Id Scheduler::start_at(IAnimation& anim, double time) {
+    std::uint32_t index = allocate({ .kind = Event::Kind::Start, .time = time, .handle = { }, .anim = &anim, .on_done = { } });
+    schedule_entry(index, time);
+    return (Id(m_entries[index].generation) << 32) | index;
+}
+
+Scheduler::Id Scheduler::on_done(IAnimation& anim, std::function<void(IAnimation&)> fn) {
+    std::uint32_t index = allocate({ .kind = Event::Kind::Done, .time = m_now, .handle = { }, .anim = &anim, .on_done = std::move(fn) });
+
+    if (anim.is_stopped())
+        park(index);
+    else
+        schedule_entry(index, m_now + get_remaining(anim));
+
+    return (Id(m_entries[index].generation) << 32) | index;
+}
+
+void Scheduler::notify_started(IAnimation const& anim) {
+    auto it = m_parked.find(&anim);
+    if (it == m_parked.end()) return;
+
+    auto parked = std::move(it->second);
+    m_parked.erase(it);
+
+    double time = m_now + get_remaining(anim);
+    for (std::uint32_t index : parked)
+        schedule_entry(index, time);
+}
+
+bool Scheduler::cancel(Id id) {
+    auto index = static_cast<std::uint32_t>(id);
+    auto generation = static_cast<std::uint32_t>(id >> 32);
+
+    if (index >= m_entries.size()) return false;
+    Entry& entry = m_entries[index];
+    if (entry.generation != generation) return false;
+
+    switch (entry.state) {
+        case Entry::State::Free:
+            return false;
+
+        case Entry::State::Scheduled:
+            m_timers.cancel(entry.timer);
+            break;
+
+        case Entry::State::Parked:
+            unpark(index);
+            break;
+    }
+
+    release(index);
+    return true;
+}
+
+void Scheduler::update(double now) {
+    m_now = now;
+
+    // scripts spawned while these run start on the next update
+    std::swap(m_spawned, m_starting);
+    for (auto handle : m_starting)
+        handle.resume();
+    m_starting.clear();
+
+    m_timers.advance(now, [&](std::uint32_t index) { fire(index); });
+}
+
+void Scheduler::schedule(Script::Handle handle, double wake, IAnimation* waiting_on) {
+    assert(handle);
+    std::uint32_t index = allocate({ .kind = Event::Kind::Resume, .time = wake, .handle = handle, .anim = waiting_on, .on_done = { } });
+    schedule_entry(index, wake);
+}
+
+std::uint32_t Scheduler::allocate(Event event) {
+    std::uint32_t index = m_free;
+
+    if (index == s_none) {
+        index = static_cast<std::uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+    } else {
+        m_free = m_entries[index].next_free;
+    }
+
+    m_entries[index].event = std::move(event);
+    m_pending++;
+    return index;
+}
+
+void Scheduler::release(std::uint32_t index) {
+    Entry& entry = m_entries[index];
+    entry.event = { };
+    entry.state = Entry::State::Free;
+    entry.generation++;
+    entry.next_free = m_free;
+    m_free = index;
+    m_pending--;
+}
+
+void Scheduler::schedule_entry(std::uint32_t index, double time) {
+    Entry& entry = m_entries[index];
+    entry.event.time = time;
+    entry.state = Entry::State::Scheduled;
+    entry.timer = m_timers.add(time, index);
+}
+
+void Scheduler::park(std::uint32_t index) {
+    Entry& entry = m_entries[index];
+    entry.state = Entry::State::Parked;
+    m_parked[entry.event.anim].push_back(index);
+}
+
+void Scheduler::unpark(std::uint32_t index) {
+    auto it = m_parked.find(m_entries[index].event.anim);
+    assert(it != m_parked.end());
+
+    auto& parked = it->second;
+    parked.erase(std::ranges::find(parked, index));
+    if (parked.empty()) m_parked.erase(it);
+}
+
+double Scheduler::get_remaining(IAnimation const& anim) {
+    if (!anim.is_running()) return 0.0f;
+    return std::max(anim.get_duration() * (1.0f - anim.get_progress()), 0.0);
+}
+
+void Scheduler::fire(std::uint32_t index) {
+    Entry& entry = m_entries[index];
+
+    // the animation might end slightly later than computed, eg. a Sequence
+    // that starts its children on dispatch(), so check again once it should
+    // be done. An animation that was reset waits until it is started again.
+    IAnimation* anim = entry.event.anim;
+    if (entry.event.kind != Event::Kind::Start && anim != nullptr && !anim->is_done()) {
+        if (anim->is_stopped())
+            park(index);
+        else
+            schedule_entry(index, m_now + get_remaining(*anim));
+        return;
+    }
+
+    // released first, as what runs below may add events
+    Event event = std::move(entry.event);
+    release(index);
+
+    switch (event.kind) {
+        case Event::Kind::Resume:
+            event.handle.resume();
+            break;
+
+        case Event::Kind::Start:
+            anim->start_at(to_ticks(event.time));
+            notify_started(*anim);
+            break;
+
+        case Event::Kind::Done:
+            event.on_done(*anim);
+            break;
+    }
+}
+
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <exception>
+#include <coroutine>
+#include <functional>
+#include <unordered_map>
+
+#include "common.hh"
+#include "timed.hh"
+#include "timer.hh"
+
+// coroutine scripting
+// a script is a coroutine returning anim::Script, that is run by a Scheduler:
+//
+// anim::Script intro(Fade& a, Slide& b, Slide& c) {
+//     co_await a;                // plays a and waits for it to finish
+//     b.start();
+//     c.start();
+//     co_await anim::delay(0.5);
+//     co_await d;
+// }
+//
+// scheduler.spawn(intro(a, b, c));
+//
+// Suspended scripts wait in a timer wheel, so update() only touches the scripts
+// that are due. Scripts must be created and run on a single thread.
+
+namespace anim {
+
+namespace detail {
+
+// coroutine frames are recycled through per-size free lists
+[[nodiscard]] void* allocate_frame(std::size_t size);
+void free_frame(void* frame, std::size_t size);
+
+}
+
+struct Delay {
+    double seconds;
+};
+
+[[nodiscard]] constexpr Delay delay(double seconds) {
+    return { seconds };
+}
+
+class Scheduler;
+
+class Script {
+public:
+    struct promise_type {
+        Scheduler* scheduler = nullptr;
+
+        Script get_return_object() {
+            return Script(Handle::from_promise(*this));
+        }
+
+        // scripts run once they are spawned
+        std::suspend_always initial_suspend() noexcept { return { }; }
+        std::suspend_never final_suspend() noexcept { return { }; }
+        void return_void() { }
+        void unhandled_exception() { std::terminate(); }
+
+        auto await_transform(Delay delay);
+        auto await_transform(IAnimation& anim);
+
+        static void* operator new(std::size_t size) {
+            return detail::allocate_frame(size);
+        }
+
+        static void operator delete(void* frame, std::size_t size) {
+            detail::free_frame(frame, size);
+        }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Script(Script&& other) noexcept : m_handle(std::exchange(other.m_handle, { })) { }
+    Script(Script const&) = delete;
+    Script& operator=(Script const&) = delete;
+    Script& operator=(Script&&) = delete;
+
+    ~Script() {
+        if (m_handle) m_handle.destroy();
+    }
+
+private:
+    Handle m_handle;
+
+    explicit Script(Handle handle) : m_handle(handle) { }
+
+    friend class Scheduler;
+
+};
+
+// resumes suspended scripts once their wake time has come, and fires
+// scheduled starts and completion callbacks
+// everything that waits is kept in a timer wheel, so update() only touches
+// what is due and waiting costs nothing per frame. Completion callbacks and
+// scripts waiting for an animation that has not been started are parked
+// until it is started through the scheduler, by start_at() or a script
+// awaiting it, or notify_started() reports that it was started elsewhere.
+class Scheduler {
+public:
+    using Id = std::uint64_t;
+
+private:
+    static constexpr std::uint32_t s_none = std::numeric_limits<std::uint32_t>::max();
+
+    struct Event {
+        enum class Kind { Resume, Start, Done };
+
+        Kind kind = Kind::Resume;
+        double time = 0.0f; // when it is due
+        Script::Handle handle; // Resume
+        IAnimation* anim = nullptr; // Start, Done, or the animation a script waits for
+        std::function<void(IAnimation&)> on_done; // Done
+    };
+
+    // events live in a pool, so ids stay valid while an event moves
+    // between the wheel and the parked events
+    struct Entry {
+        enum class State { Free, Scheduled, Parked };
+
+        Event event;
+        State state = State::Free;
+        std::uint32_t generation = 0;
+        std::uint32_t next_free = s_none;
+        TimerWheel<std::uint32_t>::Id timer = 0;
+    };
+
+    TimerWheel<std::uint32_t> m_timers; // indices into m_entries
+    std::vector<Entry> m_entries;
+    std::uint32_t m_free = s_none;
+    std::size_t m_pending = 0;
+    std::unordered_map<IAnimation const*, std::vector<std::uint32_t>> m_parked; // by animation
+    std::vector<Script::Handle> m_spawned;
+    std::vector<Script::Handle> m_starting; // scratch space for update()
+    double m_now;
+
+public:
+    // time is split into ticks of the given resolution in seconds,
+    // which events may fire up to one tick late
+    explicit Scheduler(double now = get_time_secs(), double resolution = 0.001);
+    Scheduler(Scheduler const&) = delete;
+    Scheduler& operator=(Scheduler const&) = delete;
+    ~Scheduler();
+
+    // the script starts running on the next update()
+    void spawn(Script script);
+
+    // starts the animation at the given time, as if start() had been called then
+    Id start_at(IAnimation& anim, double time);
+
+    // calls fn on the first update() after the animation is done
+    // waits for the animation to be started first, if it is not yet
+    Id on_done(IAnimation& anim, std::function<void(IAnimation&)> fn);
+
+    // schedules what is parked until the animation is started, for animations
+    // that were started without the scheduler, eg. by calling start()
+    void notify_started(IAnimation const& anim);
+
+    // cancels a scheduled start or callback that has not fired yet, returns false otherwise
+    bool cancel(Id id);
+
+    // resumes all scripts and fires all events that are due at the given time
+    void update(double now = get_time_secs());
+
+    // time of the last update(), which delays and awaited animations are timed from
+    [[nodiscard]] double now() const {
+        return m_now;
+    }
+
+    // number of suspended scripts and pending events
+    [[nodiscard]] std::size_t size() const {
+        return m_pending + m_spawned.size();
+    }
+
+    void schedule(Script::Handle handle, double wake, IAnimation* waiting_on = nullptr);
+
+private:
+    [[nodiscard]] std::uint32_t allocate(Event event);
+    void release(std::uint32_t index);
+    void schedule_entry(std::uint32_t index, double time);
+    void park(std::uint32_t index);
+    void unpark(std::uint32_t index);
+    void fire(std::uint32_t index);
+
+    // until the animation is done, if it is running
+    [[nodiscard]] static double get_remaining(IAnimation const& anim);
+
+};
+
+inline auto Script::promise_type::await_transform(Delay delay) {
+    struct Awaiter {
+        Delay delay;
+
+        bool await_ready() const noexcept {
+            return delay.seconds <= 0.0f;
+        }
+
+        void await_suspend(Handle handle) const {
+            Scheduler& scheduler = *handle.promise().scheduler;
+            scheduler.schedule(handle, scheduler.now() + delay.seconds);
+        }
+
+        void await_resume() const noexcept { }
+    };
+
+    return Awaiter { delay };
+}
+
+// plays the animation, unless it is already running or about to start, and
+// waits until it is done
+inline auto Script::promise_type::await_transform(IAnimation& anim) {
+    struct Awaiter {
+        IAnimation& anim;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(Handle handle) const {
+            Scheduler& scheduler = *handle.promise().scheduler;
+            double remaining = anim.get_duration();
+
+            // one that starts in the future is checked again after its duration
+            if (anim.is_stopped() || anim.is_done()) {
+                anim.start_at(to_ticks(scheduler.now()));
+                scheduler.notify_started(anim);
+            } else if (anim.is_running()) {
+                remaining *= 1.0f - anim.get_progress();
+            }
+
+            scheduler.schedule(handle, scheduler.now() + remaining, &anim);
+        }
+
+        void await_resume() const noexcept { }
+    };
+
+    return Awaiter { anim };
+}
+
+}
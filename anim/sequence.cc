@@ -20,32 +20,46 @@ void Sequence::add(IAnimation& anim) {
 }
 
 void Sequence::dispatch() {
+    ANIM_PROFILE_COUNT(SequenceDispatch);
+
     bool running = m_current.has_value();
     if (!running) return;
 
     auto& it = m_current.value();
 
     if (it->get().is_done()) {
+        ANIM_TRACE_INSTANT("done", typeid(it->get()).name(), &it->get());
         it++;
 
         bool is_at_end = m_current == m_anims.end();
         if (is_at_end) {
+            ANIM_TRACE_INSTANT("done", typeid(*this).name(), this);
             m_current = { };
             return;
         }
 
+        ANIM_TRACE_INSTANT("dispatch", typeid(it->get()).name(), &it->get());
         it->get().start();
     }
 
 }
 
 void Sequence::start() {
+    ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
     reset();
     m_anims.front().get().start();
     m_current = m_anims.begin();
 }
 
+void Sequence::start_at(Ticks time) {
+    ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
+    reset();
+    m_anims.front().get().start_at(time);
+    m_current = m_anims.begin();
+}
+
 void Sequence::reset() {
+    ANIM_TRACE_INSTANT("reset", typeid(*this).name(), this);
     for (auto& anim : m_anims)
     anim.get().reset();
     m_current = { };
@@ -53,31 +67,34 @@ void Sequence::reset() {
 
 [[nodiscard]] double Sequence::get_progress() const {
 
-    double time_to_interp = 0.0f;
+    Ticks time_to_interp = Ticks::zero();
 
     auto fn = [&](std::reference_wrapper<IAnimation> const& interp) {
-        time_to_interp += interp.get().get_duration();
+        time_to_interp += interp.get().get_duration_ticks();
         return interp.get().is_running();
     };
 
     auto current = std::ranges::find_if(m_anims, fn);
     assert(current != m_anims.end());
 
-    double duration = current->get().get_duration();
+    Ticks duration = current->get().get_duration_ticks();
     time_to_interp -= duration; // compensate overshoot
 
-    double t = current->get().get_progress() * duration;
-    double progress_abs = time_to_interp + t;
+    double t = current->get().get_progress() * static_cast<double>(duration.count());
+    double progress_abs = static_cast<double>(time_to_interp.count()) + t;
 
-    return progress_abs / get_duration();
+    return progress_abs / static_cast<double>(get_duration_ticks().count());
 }
 
 [[nodiscard]] double Sequence::get_duration() const {
-    auto fn = [](double acc, std::reference_wrapper<IAnimation> const& elem) {
-        return acc + elem.get().get_duration();
+    return to_seconds(get_duration_ticks());
+}
+
+[[nodiscard]] Ticks Sequence::get_duration_ticks() const {
+    auto fn = [](Ticks acc, std::reference_wrapper<IAnimation> const& elem) {
+        return acc + elem.get().get_duration_ticks();
     };
-    double t = std::accumulate(m_anims.cbegin(), m_anims.cend(), 0.0f, fn);
-    return t;
+    return std::accumulate(m_anims.cbegin(), m_anims.cend(), Ticks::zero(), fn);
 }
 
 [[nodiscard]] bool Sequence::is_stopped() const {
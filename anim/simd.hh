@@ -0,0 +1,472 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <array>
+#include <cmath>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <type_traits>
+
+#include "common.hh"
+
+// array lerp kernels, and the decoders of 16-bit keyframe values for quantized.hh
+// the float kernels pack components into 4-wide vector registers via the
+// gcc/clang vector extensions (sse/neon natively, wasm with -msimd128),
+// and fall back to scalar loops on other compilers
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ANIM_SIMD_VECTOR_EXT
+#endif
+
+namespace anim {
+
+namespace simd {
+
+#ifdef ANIM_SIMD_VECTOR_EXT
+
+using f32x4 = float __attribute__((vector_size(16)));
+
+namespace detail {
+
+[[nodiscard]] inline f32x4 load(float const* src) {
+    f32x4 v;
+    std::memcpy(&v, src, sizeof(v));
+    return v;
+}
+
+inline void store(float* dst, f32x4 v) {
+    std::memcpy(dst, &v, sizeof(v));
+}
+
+// register R of a block of 4 elements with C components each
+template <std::size_t C, std::size_t R>
+inline void lerp_register(float const* a, float const* b, float const* x, float* out) {
+    constexpr std::size_t first = R * 4;
+    f32x4 w = { x[(first + 0) / C], x[(first + 1) / C], x[(first + 2) / C], x[(first + 3) / C] };
+    f32x4 va = load(a + first);
+    f32x4 vb = load(b + first);
+    store(out + first, va + w * (vb - va));
+}
+
+}
+
+#endif // ANIM_SIMD_VECTOR_EXT
+
+// out[i] = a[i] + x * (b[i] - a[i]) for n floats
+inline void lerp_floats(float const* a, float const* b, float x, float* out, std::size_t n) {
+    std::size_t i = 0;
+
+#ifdef ANIM_SIMD_VECTOR_EXT
+    for (; i + 4 <= n; i += 4) {
+        f32x4 va = detail::load(a + i);
+        f32x4 vb = detail::load(b + i);
+        detail::store(out + i, va + x * (vb - va));
+    }
+#endif
+
+    for (; i < n; ++i)
+        out[i] = a[i] + x * (b[i] - a[i]);
+}
+
+// lerps count elements of C floats each, every element with its own weight
+template <std::size_t C>
+inline void lerp_floats(float const* a, float const* b, float const* x, float* out, std::size_t count) {
+    std::size_t i = 0;
+
+#ifdef ANIM_SIMD_VECTOR_EXT
+    // 4 elements fill exactly C registers
+    for (; i + 4 <= count; i += 4) {
+        std::size_t offset = i * C;
+        [&]<std::size_t... R>(std::index_sequence<R...>) {
+            (detail::lerp_register<C, R>(a + offset, b + offset, x + i, out + offset), ...);
+        }(std::make_index_sequence<C>());
+    }
+#endif
+
+    for (; i < count; ++i)
+        for (std::size_t c = 0; c < C; ++c)
+            out[i * C + c] = a[i * C + c] + x[i] * (b[i * C + c] - a[i * C + c]);
+}
+
+// 8-bit fixed point lerp of n bytes, weight is in 0..256
+// a * (256 - w) + b * w + 128 never exceeds 16 bits
+inline void lerp_bytes(std::uint8_t const* a, std::uint8_t const* b, std::uint32_t weight,
+                       std::uint8_t* out, std::size_t n) {
+    assert(weight <= 256);
+    auto w = static_cast<std::uint16_t>(weight);
+    auto inv = static_cast<std::uint16_t>(256 - weight);
+    std::size_t i = 0;
+
+#ifdef ANIM_SIMD_VECTOR_EXT
+    // spelled out, as compilers only vectorize the scalar loop below at -O3
+    using u8x16 = std::uint8_t __attribute__((vector_size(16)));
+    using u16x16 = std::uint16_t __attribute__((vector_size(32)));
+
+    for (; i + 16 <= n; i += 16) {
+        u8x16 va, vb;
+        std::memcpy(&va, a + i, sizeof(va));
+        std::memcpy(&vb, b + i, sizeof(vb));
+
+        u16x16 wa = __builtin_convertvector(va, u16x16);
+        u16x16 wb = __builtin_convertvector(vb, u16x16);
+        u8x16 r = __builtin_convertvector((wa * inv + wb * w + 128) >> 8, u8x16);
+
+        std::memcpy(out + i, &r, sizeof(r));
+    }
+#endif
+
+    for (; i < n; ++i)
+        out[i] = static_cast<std::uint8_t>((a[i] * inv + b[i] * w + 128) >> 8);
+}
+
+[[nodiscard]] inline std::uint32_t to_fixed_weight(float x) {
+    if (x <= 0.0f) return 0;
+    if (x >= 1.0f) return 256;
+    return static_cast<std::uint32_t>(x * 256.0f + 0.5f);
+}
+
+// ieee 754 half precision, rounded to nearest even, out of range values become infinity
+[[nodiscard]] inline std::uint16_t to_half(float value) {
+    static constexpr std::uint32_t s_max = (127 + 16) << 23; // 65536, the first that overflows
+    static constexpr std::uint32_t s_denormal_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    auto bits = std::bit_cast<std::uint32_t>(value);
+    std::uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    std::uint32_t out;
+    if (bits >= s_max) {
+        out = bits > 0x7f800000u ? 0x7e00 : 0x7c00; // nan stays nan
+    } else if (bits < (113u << 23)) {
+        // subnormal, the addition aligns the mantissa and rounds it
+        float aligned = std::bit_cast<float>(bits) + std::bit_cast<float>(s_denormal_magic);
+        out = std::bit_cast<std::uint32_t>(aligned) - s_denormal_magic;
+    } else {
+        std::uint32_t odd = (bits >> 13) & 1;
+        bits += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfff + odd;
+        out = bits >> 13;
+    }
+
+    return static_cast<std::uint16_t>(out | (sign >> 16));
+}
+
+[[nodiscard]] inline float from_half(std::uint16_t half) {
+    static constexpr std::uint32_t s_exponent = 0x7c00 << 13;
+    static constexpr float s_magic = 0x1p-14f;
+
+    std::uint32_t bits = (half & 0x7fffu) << 13;
+    std::uint32_t exponent = bits & s_exponent;
+    bits += (127 - 15) << 23;
+
+    if (exponent == s_exponent) {
+        bits += (128 - 16) << 23; // inf or nan
+    } else if (exponent == 0) {
+        // zero or subnormal, renormalized by the float unit
+        bits += 1 << 23;
+        bits = std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits) - s_magic);
+    }
+
+    return std::bit_cast<float>(bits | ((half & 0x8000u) << 16));
+}
+
+// n half floats to floats
+inline void half_to_floats(std::uint16_t const* src, float* out, std::size_t n) {
+#ifdef ANIM_SIMD_VECTOR_EXT
+    // from_half() with selects instead of branches
+    using u16x4 = std::uint16_t __attribute__((vector_size(8)));
+    using u32x4 = std::uint32_t __attribute__((vector_size(16)));
+    static constexpr std::uint32_t s_exponent = 0x7c00 << 13;
+
+    auto convert = [](u16x4 half) {
+        u32x4 wide = __builtin_convertvector(half, u32x4);
+
+        u32x4 bits = (wide & 0x7fffu) << 13;
+        u32x4 exponent = bits & s_exponent;
+        bits += (127 - 15) << 23;
+
+        auto special = std::bit_cast<u32x4>(exponent == s_exponent);
+        auto subnormal = std::bit_cast<u32x4>(exponent == 0);
+        bits += special & ((128 - 16) << 23);
+        bits += subnormal & (1 << 23);
+
+        auto renormalized = std::bit_cast<u32x4>(std::bit_cast<f32x4>(bits) - 0x1p-14f);
+        bits = (renormalized & subnormal) | (bits & ~subnormal);
+
+        return std::bit_cast<f32x4>(bits | ((wide & 0x8000u) << 16));
+    };
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        u16x4 half;
+        std::memcpy(&half, src + i, sizeof(half));
+        detail::store(out + i, convert(half));
+    }
+
+    // the rest padded to one register, unless only one or two remain
+    if (i + 2 < n) {
+        u16x4 half { };
+        std::memcpy(&half, src + i, (n - i) * sizeof(std::uint16_t));
+        f32x4 values = convert(half);
+        std::memcpy(out + i, &values, (n - i) * sizeof(float));
+    } else {
+        for (; i < n; ++i) out[i] = from_half(src[i]);
+    }
+#else
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = from_half(src[i]);
+#endif
+}
+
+// count elements of C components each from unsigned 16-bit integers,
+// component c becomes offset[c] + q * scale[c]
+template <std::size_t C>
+inline void unorm16_to_floats(std::uint16_t const* src, float const* scale, float const* offset,
+                              float* out, std::size_t count) {
+#ifdef ANIM_SIMD_VECTOR_EXT
+    // the components are converted as one flat run, 4 elements fill exactly
+    // C registers, register r holds the components (4r + k) % C, so its scale
+    // and offset repeat every C registers
+    using u16x4 = std::uint16_t __attribute__((vector_size(8)));
+    std::array<f32x4, C> scales, offsets;
+    for (std::size_t r = 0; r < C; ++r) {
+        for (std::size_t k = 0; k < 4; ++k) {
+            scales[r][k] = scale[(r * 4 + k) % C];
+            offsets[r][k] = offset[(r * 4 + k) % C];
+        }
+    }
+
+    std::size_t n = count * C;
+    std::size_t i = 0, r = 0;
+    for (; i + 4 <= n; i += 4) {
+        u16x4 q;
+        std::memcpy(&q, src + i, sizeof(q));
+        detail::store(out + i, __builtin_convertvector(q, f32x4) * scales[r] + offsets[r]);
+        r = r + 1 == C ? 0 : r + 1;
+    }
+
+    // the rest padded to one register, unless only one or two remain
+    if (i + 2 < n) {
+        u16x4 q { };
+        std::memcpy(&q, src + i, (n - i) * sizeof(std::uint16_t));
+        f32x4 values = __builtin_convertvector(q, f32x4) * scales[r] + offsets[r];
+        std::memcpy(out + i, &values, (n - i) * sizeof(float));
+    } else {
+        for (; i < n; ++i) out[i] = offset[i % C] + static_cast<float>(src[i]) * scale[i % C];
+    }
+#else
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t c = 0; c < C; ++c)
+            out[i * C + c] = offset[c] + static_cast<float>(src[i * C + c]) * scale[c];
+#endif
+}
+
+inline void lerp(std::span<const float> a, std::span<const float> b, float x, std::span<float> out) {
+    assert(a.size() == out.size() && b.size() == out.size());
+    lerp_floats(a.data(), b.data(), x, out.data(), out.size());
+}
+
+inline void lerp(std::span<const float> a, std::span<const float> b,
+                 std::span<const float> x, std::span<float> out) {
+    assert(a.size() == out.size() && b.size() == out.size() && x.size() == out.size());
+    lerp_floats<1>(a.data(), b.data(), x.data(), out.data(), out.size());
+}
+
+#ifdef ANIM_INTEGRATION_RAYLIB
+
+namespace detail {
+
+template <typename T>
+constexpr std::size_t float_count = sizeof(T) / sizeof(float);
+
+template <typename T>
+void lerp_vectors(std::span<const T> a, std::span<const T> b, float x, std::span<T> out) {
+    static_assert(sizeof(T) == float_count<T> * sizeof(float));
+    assert(a.size() == out.size() && b.size() == out.size());
+
+    lerp_floats(reinterpret_cast<float const*>(a.data()),
+                reinterpret_cast<float const*>(b.data()),
+                x,
+                reinterpret_cast<float*>(out.data()),
+                out.size() * float_count<T>);
+}
+
+template <typename T>
+void lerp_vectors(std::span<const T> a, std::span<const T> b, std::span<const float> x, std::span<T> out) {
+    static_assert(sizeof(T) == float_count<T> * sizeof(float));
+    assert(a.size() == out.size() && b.size() == out.size() && x.size() == out.size());
+
+    lerp_floats<float_count<T>>(reinterpret_cast<float const*>(a.data()),
+                                reinterpret_cast<float const*>(b.data()),
+                                x.data(),
+                                reinterpret_cast<float*>(out.data()),
+                                out.size());
+}
+
+}
+
+inline void lerp(std::span<const Vector2> a, std::span<const Vector2> b, float x, std::span<Vector2> out) {
+    detail::lerp_vectors(a, b, x, out);
+}
+
+inline void lerp(std::span<const Vector2> a, std::span<const Vector2> b,
+                 std::span<const float> x, std::span<Vector2> out) {
+    detail::lerp_vectors(a, b, x, out);
+}
+
+inline void lerp(std::span<const Vector3> a, std::span<const Vector3> b, float x, std::span<Vector3> out) {
+    detail::lerp_vectors(a, b, x, out);
+}
+
+inline void lerp(std::span<const Vector3> a, std::span<const Vector3> b,
+                 std::span<const float> x, std::span<Vector3> out) {
+    detail::lerp_vectors(a, b, x, out);
+}
+
+inline void lerp(std::span<const Rectangle> a, std::span<const Rectangle> b, float x, std::span<Rectangle> out) {
+    detail::lerp_vectors(a, b, x, out);
+}
+
+inline void lerp(std::span<const Rectangle> a, std::span<const Rectangle> b,
+                 std::span<const float> x, std::span<Rectangle> out) {
+    detail::lerp_vectors(a, b, x, out);
+}
+
+// rounds to nearest, where ColorLerp() truncates, so results may differ by one
+inline void lerp(std::span<const Color> a, std::span<const Color> b, float x, std::span<Color> out) {
+    static_assert(sizeof(Color) == 4);
+    assert(a.size() == out.size() && b.size() == out.size());
+
+    lerp_bytes(reinterpret_cast<std::uint8_t const*>(a.data()),
+               reinterpret_cast<std::uint8_t const*>(b.data()),
+               to_fixed_weight(x),
+               reinterpret_cast<std::uint8_t*>(out.data()),
+               out.size() * sizeof(Color));
+}
+
+inline void lerp(std::span<const Color> a, std::span<const Color> b,
+                 std::span<const float> x, std::span<Color> out) {
+    assert(a.size() == out.size() && b.size() == out.size() && x.size() == out.size());
+
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        lerp_bytes(reinterpret_cast<std::uint8_t const*>(&a[i]),
+                   reinterpret_cast<std::uint8_t const*>(&b[i]),
+                   to_fixed_weight(x[i]),
+                   reinterpret_cast<std::uint8_t*>(&out[i]),
+                   sizeof(Color));
+    }
+}
+
+namespace detail {
+
+[[nodiscard]] inline Quaternion nlerp(Quaternion const& a, Quaternion const& b, float x) {
+#ifdef ANIM_SIMD_VECTOR_EXT
+    f32x4 va = load(reinterpret_cast<float const*>(&a));
+    f32x4 vb = load(reinterpret_cast<float const*>(&b));
+
+    f32x4 d = va * vb;
+    if (d[0] + d[1] + d[2] + d[3] < 0.0f) vb = -vb;
+
+    f32x4 r = va + x * (vb - va);
+    f32x4 sq = r * r;
+    float length = std::sqrt(sq[0] + sq[1] + sq[2] + sq[3]);
+    if (length > 0.0f) r = r / length;
+
+    Quaternion result;
+    store(reinterpret_cast<float*>(&result), r);
+    return result;
+#else
+    // same shorter arc as above, which QuaternionNlerp() does not take by itself
+    Quaternion to = b;
+    if (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f)
+        to = { -b.x, -b.y, -b.z, -b.w };
+
+    return QuaternionNlerp(a, to, x);
+#endif
+}
+
+}
+
+// normalized lerp along the shorter arc, a cheaper approximation of slerp
+// that is accurate for the small steps between consecutive frames
+inline void nlerp(std::span<const Quaternion> a, std::span<const Quaternion> b,
+                  std::span<const float> x, std::span<Quaternion> out) {
+    assert(a.size() == out.size() && b.size() == out.size() && x.size() == out.size());
+
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = detail::nlerp(a[i], b[i], x[i]);
+}
+
+inline void nlerp(std::span<const Quaternion> a, std::span<const Quaternion> b,
+                  float x, std::span<Quaternion> out) {
+    assert(a.size() == out.size() && b.size() == out.size());
+
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = detail::nlerp(a[i], b[i], x);
+}
+
+#endif // ANIM_INTEGRATION_RAYLIB
+
+}
+
+// out[i] = lerp(a[i], b[i], x[i]), the batched counterpart of lerp()
+// falls back to calling lerp() per element. Types with a layout that suits
+// the kernels above may provide their own version, just like lerp():
+// template <> inline void anim::lerp_n<MyType>(std::span<const MyType> a, ...) { ... }
+template <Interpolatable T>
+void lerp_n(std::span<const T> a, std::span<const T> b, std::span<const float> x, std::span<T> out) {
+    assert(a.size() == out.size() && b.size() == out.size() && x.size() == out.size());
+
+    constexpr bool component_wise = enable_component_lerp<T> || detail::is_arithmetic_array<T>;
+
+    if constexpr (component_wise && Decomposable<T>) {
+        if constexpr (std::is_same_v<typename Components<T>::value_type, float>) {
+            // a flat array of floats, every element with its own weight
+            simd::lerp_floats<Components<T>::count>(reinterpret_cast<float const*>(a.data()),
+                                                    reinterpret_cast<float const*>(b.data()),
+                                                    x.data(),
+                                                    reinterpret_cast<float*>(out.data()),
+                                                    out.size());
+            return;
+        }
+    }
+
+    for (std::size_t i = 0; i < out.size(); ++i)
+        out[i] = anim::lerp(a[i], b[i], x[i]);
+}
+
+template <>
+inline void lerp_n<float>(std::span<const float> a, std::span<const float> b,
+                          std::span<const float> x, std::span<float> out) {
+    simd::lerp(a, b, x, out);
+}
+
+#ifdef ANIM_INTEGRATION_RAYLIB
+
+// Color and Quaternion keep the default, as the kernels above round
+// differently than ColorLerp() and QuaternionSlerp()
+
+template <>
+inline void lerp_n<Vector2>(std::span<const Vector2> a, std::span<const Vector2> b,
+                            std::span<const float> x, std::span<Vector2> out) {
+    simd::lerp(a, b, x, out);
+}
+
+template <>
+inline void lerp_n<Vector3>(std::span<const Vector3> a, std::span<const Vector3> b,
+                            std::span<const float> x, std::span<Vector3> out) {
+    simd::lerp(a, b, x, out);
+}
+
+template <>
+inline void lerp_n<Rectangle>(std::span<const Rectangle> a, std::span<const Rectangle> b,
+                              std::span<const float> x, std::span<Rectangle> out) {
+    simd::lerp(a, b, x, out);
+}
+
+#endif // ANIM_INTEGRATION_RAYLIB
+
+}
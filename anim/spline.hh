@@ -0,0 +1,331 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "common.hh"
+#include "components.hh"
+#include "timed.hh"
+
+// smooth curves through many keyframes
+//
+// Animation<T> chains independent interpolators, so the velocity jumps at
+// every keyframe. A spline is a piecewise cubic with matching tangents at
+// the keyframes instead. Each segment is stored as the coefficients of its
+// polynomial, so evaluating one is a lookup and a horner scheme per component.
+//
+// catmull_rom: tangents from the neighbouring keyframes, for paths through points
+// monotone:    never overshoots the keyframes (Fritsch-Carlson), for values
+//              such as opacity that must stay in range
+// hermite:     tangents given per keyframe, in units per second, as scalars per
+//              component, so they may be negative and fractional for integer
+//              components too
+//
+// Components are splined independently (see components.hh), so quaternions
+// are not kept normalized and integer components are rounded and clamped.
+
+namespace anim {
+
+template <typename T> requires Decomposable<T>
+class Spline {
+    using C = Components<T>;
+    static constexpr std::size_t N = C::count;
+
+    // components are evaluated in double only if they are double already
+    using Scalar = std::conditional_t<std::is_same_v<typename C::value_type, double>, double, float>;
+    using Vector = std::array<Scalar, N>;
+
+    struct Segment {
+        double start;
+        double inv_duration;
+        std::array<Vector, 4> coeffs; // cubic first, so p(u) = ((a * u + b) * u + c) * u + d
+    };
+
+public:
+    using Tangent = Vector;
+
+    struct Key {
+        double time;
+        T value;
+    };
+
+    struct HermiteKey {
+        double time;
+        T value;
+        Tangent tangent; // change per second, per component
+    };
+
+private:
+    std::vector<double> m_times; // key times, segment i spans m_times[i]..m_times[i + 1]
+    std::vector<Segment> m_segments;
+    T m_start;
+    T m_end;
+
+public:
+    [[nodiscard]] static Spline catmull_rom(std::span<const Key> keys) {
+        auto [times, values] = split(keys);
+        std::vector<Vector> tangents(values.size());
+
+        std::size_t last = values.size() - 1;
+        for (std::size_t i = 0; i <= last; ++i) {
+            std::size_t prev = i == 0 ? 0 : i - 1;
+            std::size_t next = i == last ? last : i + 1;
+            auto dt = static_cast<Scalar>(times[next] - times[prev]);
+
+            for (std::size_t c = 0; c < N; ++c)
+                tangents[i][c] = (values[next][c] - values[prev][c]) / dt;
+        }
+
+        return Spline(std::move(times), values, tangents, keys.front().value, keys.back().value);
+    }
+
+    [[nodiscard]] static Spline monotone(std::span<const Key> keys) {
+        auto [times, values] = split(keys);
+        std::size_t segments = values.size() - 1;
+        std::vector<Vector> tangents(values.size());
+
+        for (std::size_t c = 0; c < N; ++c) {
+            // secants, then their average where the slope keeps its sign
+            std::vector<Scalar> secants(segments);
+            for (std::size_t i = 0; i < segments; ++i)
+                secants[i] = (values[i + 1][c] - values[i][c]) / static_cast<Scalar>(times[i + 1] - times[i]);
+
+            tangents.front()[c] = secants.front();
+            tangents.back()[c] = secants.back();
+            for (std::size_t i = 1; i < segments; ++i) {
+                Scalar a = secants[i - 1], b = secants[i];
+                tangents[i][c] = a * b <= 0 ? 0 : (a + b) / 2;
+            }
+
+            // shrink tangents that would overshoot
+            for (std::size_t i = 0; i < segments; ++i) {
+                if (secants[i] == 0) {
+                    tangents[i][c] = tangents[i + 1][c] = 0;
+                    continue;
+                }
+
+                Scalar alpha = tangents[i][c] / secants[i];
+                Scalar beta = tangents[i + 1][c] / secants[i];
+                Scalar length = alpha * alpha + beta * beta;
+
+                if (length > 9) {
+                    Scalar tau = 3 / std::sqrt(length);
+                    tangents[i][c] = tau * alpha * secants[i];
+                    tangents[i + 1][c] = tau * beta * secants[i];
+                }
+            }
+        }
+
+        return Spline(std::move(times), values, tangents, keys.front().value, keys.back().value);
+    }
+
+    [[nodiscard]] static Spline hermite(std::span<const HermiteKey> keys) {
+        assert(keys.size() >= 2 && "a spline needs at least two keys");
+        std::vector<double> times;
+        std::vector<Vector> values, tangents;
+
+        times.reserve(keys.size());
+        values.reserve(keys.size());
+        tangents.reserve(keys.size());
+
+        for (auto const& key : keys) {
+            times.push_back(key.time);
+            values.push_back(to_scalars(key.value));
+            tangents.push_back(key.tangent);
+        }
+
+        return Spline(std::move(times), values, tangents, keys.front().value, keys.back().value);
+    }
+
+    [[nodiscard]] static Spline catmull_rom(std::initializer_list<Key> keys) {
+        return catmull_rom(std::span(keys.begin(), keys.size()));
+    }
+
+    [[nodiscard]] static Spline monotone(std::initializer_list<Key> keys) {
+        return monotone(std::span(keys.begin(), keys.size()));
+    }
+
+    [[nodiscard]] static Spline hermite(std::initializer_list<HermiteKey> keys) {
+        return hermite(std::span(keys.begin(), keys.size()));
+    }
+
+    // time of the last key, the spline holds the first value until the first key
+    [[nodiscard]] double get_duration() const {
+        return m_times.back();
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_times.size();
+    }
+
+    [[nodiscard]] T get_start() const {
+        return m_start;
+    }
+
+    [[nodiscard]] T get_end() const {
+        return m_end;
+    }
+
+    // binary search for the segment
+    [[nodiscard]] T get(double t) const {
+        std::size_t cursor = 0;
+        return get(t, cursor);
+    }
+
+    // cursor is the segment of the previous lookup, so playback that moves
+    // forward finds its segment in constant time, and only jumps search
+    [[nodiscard]] T get(double t, std::size_t& cursor) const {
+        if (t <= m_times.front()) return m_start;
+        if (t >= m_times.back()) return m_end;
+
+        if (cursor >= m_segments.size() || t < m_times[cursor]) {
+            cursor = find_segment(t);
+        } else if (t >= m_times[cursor + 1]) {
+            if (cursor + 2 < m_times.size() && t < m_times[cursor + 2])
+                ++cursor;
+            else
+                cursor = find_segment(t);
+        }
+
+        return evaluate(m_segments[cursor], t);
+    }
+
+private:
+    Spline(std::vector<double> times, std::vector<Vector> const& values,
+           std::vector<Vector> const& tangents, T start, T end)
+        : m_times(std::move(times))
+        , m_start(start)
+        , m_end(end)
+    {
+        m_segments.reserve(m_times.size() - 1);
+
+        for (std::size_t i = 0; i + 1 < m_times.size(); ++i) {
+            double duration = m_times[i + 1] - m_times[i];
+            auto h = static_cast<Scalar>(duration);
+            Segment& segment = m_segments.emplace_back(m_times[i], 1.0 / duration);
+
+            // cubic hermite basis, with the tangents scaled to u in 0..1
+            for (std::size_t c = 0; c < N; ++c) {
+                Scalar p0 = values[i][c], p1 = values[i + 1][c];
+                Scalar m0 = tangents[i][c] * h, m1 = tangents[i + 1][c] * h;
+
+                segment.coeffs[0][c] = 2 * p0 - 2 * p1 + m0 + m1;
+                segment.coeffs[1][c] = -3 * p0 + 3 * p1 - 2 * m0 - m1;
+                segment.coeffs[2][c] = m0;
+                segment.coeffs[3][c] = p0;
+            }
+        }
+
+        ANIM_PROFILE_ALLOC(T, m_times.capacity() * sizeof(double) + m_segments.capacity() * sizeof(Segment));
+    }
+
+    [[nodiscard]] static auto split(std::span<const Key> keys) {
+        assert(keys.size() >= 2 && "a spline needs at least two keys");
+        std::vector<double> times;
+        std::vector<Vector> values;
+
+        times.reserve(keys.size());
+        values.reserve(keys.size());
+
+        for (auto const& key : keys) {
+            assert((times.empty() || key.time > times.back()) && "key times must increase");
+            times.push_back(key.time);
+            values.push_back(to_scalars(key.value));
+        }
+
+        return std::pair { std::move(times), std::move(values) };
+    }
+
+    [[nodiscard]] std::size_t find_segment(double t) const {
+        auto it = std::ranges::upper_bound(m_times, t);
+        return static_cast<std::size_t>(it - m_times.begin()) - 1;
+    }
+
+    [[nodiscard]] static T evaluate(Segment const& segment, double t) {
+        auto u = static_cast<Scalar>((t - segment.start) * segment.inv_duration);
+        auto const& [a, b, c, d] = segment.coeffs;
+
+        Vector out;
+        for (std::size_t i = 0; i < N; ++i)
+            out[i] = ((a[i] * u + b[i]) * u + c[i]) * u + d[i];
+
+        return from_scalars(out);
+    }
+
+    [[nodiscard]] static Vector to_scalars(T value) {
+        auto array = C::to_array(value);
+        Vector out;
+        for (std::size_t i = 0; i < N; ++i)
+            out[i] = static_cast<Scalar>(array[i]);
+        return out;
+    }
+
+    [[nodiscard]] static T from_scalars(Vector const& values) {
+        using V = typename C::value_type;
+
+        if constexpr (std::is_same_v<V, Scalar>) {
+            return C::from_array(values);
+
+        } else {
+            std::array<V, N> array;
+            for (std::size_t i = 0; i < N; ++i) {
+                Scalar value = values[i];
+
+                if constexpr (std::is_integral_v<V>) {
+                    // splines overshoot, so clamp before narrowing
+                    value = std::clamp(std::round(value),
+                                       static_cast<Scalar>(std::numeric_limits<V>::lowest()),
+                                       static_cast<Scalar>(std::numeric_limits<V>::max()));
+                }
+
+                array[i] = static_cast<V>(value);
+            }
+            return C::from_array(array);
+        }
+    }
+
+};
+
+// plays back a spline, which it owns
+// remembers the segment of the last get(), so reads should come from one thread
+template <typename T> requires Decomposable<T>
+class SplineAnimation : public TimedAnimation {
+    Spline<T> m_spline;
+    mutable std::size_t m_cursor = 0;
+
+public:
+    SplineAnimation(Spline<T> spline) : m_spline(std::move(spline)) { }
+
+    [[nodiscard]] double get_duration() const override {
+        return m_spline.get_duration();
+    }
+
+    [[nodiscard]] Spline<T> const& get_spline() const {
+        return m_spline;
+    }
+
+    [[nodiscard]] T get() const {
+        ANIM_PROFILE_COUNT(AnimationGet);
+
+        auto elapsed = get_elapsed();
+        if (!elapsed)
+            return m_spline.get_start();
+
+        return m_spline.get(*elapsed, m_cursor);
+    }
+
+    operator T() const {
+        return get();
+    }
+
+};
+
+}
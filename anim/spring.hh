@@ -0,0 +1,316 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "common.hh"
+#include "components.hh"
+#include "timed.hh"
+
+// damped springs, evaluated with the analytic solution of
+// m * x'' + c * x' + k * x = 0
+//
+// A spring is a function of time, not a simulation, so its value does not
+// depend on the frame rate, and it may be seeked like any other animation.
+// The displacement is linear in the initial displacement and velocity:
+//
+// x(t) = fx(t) * x0 + gx(t) * v0
+// v(t) = fv(t) * x0 + gv(t) * v0
+//
+// so one set of factors per evaluation serves all components of a value.
+// Springs settle asymptotically, their duration is when the displacement
+// stays below a threshold for good, after which they snap onto the target.
+
+namespace anim {
+
+class Spring {
+public:
+    struct Factors {
+        double fx, gx; // displacement
+        double fv, gv; // velocity
+    };
+
+private:
+    enum class Kind { Underdamped, Critical, Overdamped };
+
+    Kind m_kind;
+    double m_omega; // undamped angular frequency
+    double m_a; // underdamped: decay rate, overdamped: slow root
+    double m_b; // underdamped: damped frequency, overdamped: fast root
+
+public:
+    // react-spring's default, a quick spring with hardly any overshoot
+    Spring() : Spring(170.0f, 26.0f) { }
+
+    Spring(double stiffness, double damping, double mass = 1.0f)
+    : m_omega(std::sqrt(stiffness / mass))
+    {
+        // without damping, a spring never settles
+        assert(stiffness > 0 && damping > 0 && mass > 0);
+        double zeta = damping / (2 * std::sqrt(stiffness * mass));
+
+        // close to critical, both other solutions lose precision
+        if (std::abs(zeta - 1) < 1e-4) {
+            m_kind = Kind::Critical;
+            m_a = m_omega;
+            m_b = 0;
+
+        } else if (zeta < 1) {
+            m_kind = Kind::Underdamped;
+            m_a = zeta * m_omega;
+            m_b = m_omega * std::sqrt(1 - zeta * zeta);
+
+        } else {
+            m_kind = Kind::Overdamped;
+            double root = m_omega * std::sqrt(zeta * zeta - 1);
+            m_a = -zeta * m_omega + root;
+            m_b = -zeta * m_omega - root;
+        }
+    }
+
+    [[nodiscard]] Factors get_factors(double t) const {
+        switch (m_kind) {
+            case Kind::Underdamped: {
+                double e = std::exp(-m_a * t);
+                double s = std::sin(m_b * t);
+                double c = std::cos(m_b * t);
+                return {
+                    e * (c + m_a / m_b * s), e * s / m_b,
+                    -e * s * m_omega * m_omega / m_b, e * (c - m_a / m_b * s),
+                };
+            }
+
+            case Kind::Critical: {
+                double e = std::exp(-m_omega * t);
+                return {
+                    e * (1 + m_omega * t), e * t,
+                    -e * m_omega * m_omega * t, e * (1 - m_omega * t),
+                };
+            }
+
+            case Kind::Overdamped: {
+                double e1 = std::exp(m_a * t);
+                double e2 = std::exp(m_b * t);
+                double inv = 1 / (m_b - m_a);
+                return {
+                    (m_b * e1 - m_a * e2) * inv, (e2 - e1) * inv,
+                    m_a * m_b * (e1 - e2) * inv, (m_b * e2 - m_a * e1) * inv,
+                };
+            }
+        }
+
+        return { };
+    }
+
+    // time after which the displacement of every component stays below
+    // threshold, for displacements up to x0 and velocities up to v0
+    [[nodiscard]] double get_settle_time(double x0, double v0, double threshold) const {
+        x0 = std::abs(x0);
+        v0 = std::abs(v0);
+        if (get_bound(x0, v0, 0) < threshold) return 0;
+
+        // the bound only decreases, so double the time until it is below
+        // the threshold, then bisect. It reaches zero once the exponentials
+        // underflow, which ends the search even for a threshold of zero.
+        auto settled = [&](double t) {
+            double bound = get_bound(x0, v0, t);
+            return bound < threshold || bound <= 0;
+        };
+
+        double lo = 0, hi = 1 / m_omega;
+        while (!settled(hi)) {
+            lo = hi;
+            hi *= 2;
+            if (!std::isfinite(hi)) return lo;
+        }
+
+        for (int i = 0; i < 48; ++i) {
+            double mid = (lo + hi) / 2;
+            if (settled(mid)) hi = mid;
+            else lo = mid;
+        }
+
+        return hi;
+    }
+
+private:
+    // a non-increasing upper bound of |x(t)|
+    [[nodiscard]] double get_bound(double x0, double v0, double t) const {
+        switch (m_kind) {
+            case Kind::Underdamped: {
+                double e = std::exp(-m_a * t);
+                return e * (x0 * (1 + m_a / m_b) + v0 / m_b);
+            }
+
+            case Kind::Critical: {
+                double e = std::exp(-m_omega * t);
+                // t * e rises until 1 / omega, so hold its peak until then
+                double peak = t < 1 / m_omega ? 1 / (m_omega * std::exp(1.0)) : e * t;
+                return x0 * e * (1 + m_omega * t) + v0 * peak;
+            }
+
+            case Kind::Overdamped: {
+                double e1 = std::exp(m_a * t);
+                double e2 = std::exp(m_b * t);
+                double inv = 1 / (m_a - m_b);
+                return (x0 * (-m_b * e1 - m_a * e2) + v0 * (e1 + e2)) * inv;
+            }
+        }
+
+        return 0;
+    }
+
+};
+
+// a spring from start to end, with values of floating point components
+// retarget() moves the end while the spring is in motion, keeping its
+// velocity, so it never jumps
+template <typename T>
+    requires Decomposable<T> && std::is_floating_point_v<typename Components<T>::value_type>
+class SpringAnimation : public TimedAnimation {
+    using C = Components<T>;
+    using Vector = std::array<typename C::value_type, C::count>;
+
+    Spring m_spring;
+    double m_threshold;
+    T m_start;
+    T m_end;
+    Vector m_velocity { }; // at start
+    double m_duration = 0.0f;
+
+public:
+    // the spring counts as settled once it stays within threshold of the end
+    SpringAnimation(T start, T end, Spring spring = { }, double threshold = 0.001f)
+        : m_spring(spring)
+        , m_threshold(threshold)
+        , m_start(start)
+        , m_end(end)
+    {
+        assert(threshold > 0 && "a spring never gets within a threshold of zero");
+        update_duration();
+    }
+
+    [[nodiscard]] double get_duration() const override {
+        return m_duration;
+    }
+
+    [[nodiscard]] T get_end() const {
+        return m_end;
+    }
+
+    [[nodiscard]] T get(double t) const {
+        if (t >= m_duration) return m_end;
+        if (t <= 0) return m_start;
+
+        auto factors = m_spring.get_factors(t);
+        auto start = C::to_array(m_start);
+        auto end = C::to_array(m_end);
+
+        Vector out;
+        for (std::size_t i = 0; i < C::count; ++i) {
+            double x0 = start[i] - end[i];
+            out[i] = end[i] + factors.fx * x0 + factors.gx * m_velocity[i];
+        }
+
+        return C::from_array(out);
+    }
+
+    // change per second
+    [[nodiscard]] T get_velocity(double t) const {
+        Vector out { };
+
+        if (t >= 0 && t < m_duration) {
+            auto factors = m_spring.get_factors(t);
+            auto start = C::to_array(m_start);
+            auto end = C::to_array(m_end);
+
+            for (std::size_t i = 0; i < C::count; ++i) {
+                double x0 = start[i] - end[i];
+                out[i] = factors.fv * x0 + factors.gv * m_velocity[i];
+            }
+        }
+
+        return C::from_array(out);
+    }
+
+    [[nodiscard]] T get() const {
+        ANIM_PROFILE_COUNT(AnimationGet);
+
+        auto elapsed = get_elapsed();
+        if (!elapsed)
+            return m_start;
+
+        return get(*elapsed);
+    }
+
+    [[nodiscard]] T get_velocity() const {
+        auto elapsed = get_elapsed();
+        return get_velocity(elapsed.value_or(0.0f));
+    }
+
+    operator T() const {
+        return get();
+    }
+
+    // continues from the current value and velocity towards a new end, and
+    // restarts the clock there, so the duration is that of the remaining motion
+    // without an active clock, only the end moves
+    void retarget(T end) {
+        retarget(end, get_time_ticks());
+    }
+
+    // same, as of the given time
+    void retarget(T end, Ticks time) {
+        auto elapsed = get_elapsed_ticks(time);
+        bool moving = elapsed && *elapsed > Ticks::zero();
+
+        if (moving) {
+            double t = to_seconds(*elapsed);
+            T value = get(t);
+            m_velocity = C::to_array(get_velocity(t));
+            m_start = value;
+        }
+
+        m_end = end;
+        update_duration();
+
+        if (moving) start_at(time);
+    }
+
+private:
+    void update_duration() {
+        auto start = C::to_array(m_start);
+        auto end = C::to_array(m_end);
+        double x0 = 0, v0 = 0;
+
+        for (std::size_t i = 0; i < C::count; ++i) {
+            x0 = std::max(x0, std::abs(static_cast<double>(start[i] - end[i])));
+            v0 = std::max(v0, std::abs(static_cast<double>(m_velocity[i])));
+        }
+
+        m_duration = m_spring.get_settle_time(x0, v0, m_threshold);
+    }
+
+};
+
+namespace interpolators {
+
+// a spring from 0 to 1 at rest as an easing, stretched over the duration of
+// the interpolator, eg. anim::interpolators::spring<300.0f, 20.0f>
+template <float Stiffness, float Damping, float Mass = 1.0f>
+[[nodiscard]] inline float spring(float x) noexcept {
+    static const Spring s_spring(Stiffness, Damping, Mass);
+    static const double s_duration = s_spring.get_settle_time(1, 0, 0.001f);
+
+    if (x <= 0) return 0;
+    if (x >= 1) return 1;
+    return 1 - s_spring.get_factors(x * s_duration).fx;
+}
+
+}
+
+}
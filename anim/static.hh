@@ -0,0 +1,242 @@
+#pragma once
+
+#include <tuple>
+#include <cassert>
+#include <algorithm>
+#include <utility>
+#include <optional>
+#include <concepts>
+#include <type_traits>
+
+#include "common.hh"
+
+// compile-time counterparts of Batch and Sequence
+// children are held in a tuple and called through their static type, so the
+// compiler can inline across the whole composition. Pass children by their most
+// derived type, as overrides in further derived classes are not dispatched to.
+
+namespace anim {
+
+template <typename A>
+concept StaticChild = std::derived_from<A, IAnimation> && !std::is_abstract_v<A>;
+
+namespace detail {
+
+// qualified calls suppress virtual dispatch
+template <typename A> void start(A& anim) { anim.A::start(); }
+template <typename A> void reset(A& anim) { anim.A::reset(); }
+template <typename A> void start_at(A& anim, Ticks time) { anim.A::start_at(time); }
+template <typename A> [[nodiscard]] double get_progress(A const& anim) { return anim.A::get_progress(); }
+template <typename A> [[nodiscard]] Ticks get_duration_ticks(A const& anim) { return anim.A::get_duration_ticks(); }
+template <typename A> [[nodiscard]] bool is_stopped(A const& anim) { return anim.A::is_stopped(); }
+template <typename A> [[nodiscard]] bool is_done(A const& anim) { return anim.A::is_done(); }
+template <typename A> [[nodiscard]] bool is_running(A const& anim) { return anim.A::is_running(); }
+
+// calls fn with the tuple element at a runtime index
+template <typename Tuple, typename Fn>
+void visit_at(Tuple const& tuple, std::size_t index, Fn fn) {
+    auto impl = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        ((Is == index ? (void) fn(std::get<Is>(tuple)) : void()), ...);
+    };
+    impl(std::make_index_sequence<std::tuple_size_v<Tuple>>());
+}
+
+}
+
+// runs animations concurrently
+template <StaticChild... Anims> requires (sizeof...(Anims) > 0)
+class StaticBatch : public IAnimation {
+    std::tuple<Anims&...> m_anims;
+
+public:
+    StaticBatch(Anims&... anims) : m_anims(anims...) { }
+
+    void start() override {
+        ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
+        std::apply([](auto&... anim) { (detail::start(anim), ...); }, m_anims);
+    }
+
+    void reset() override {
+        ANIM_TRACE_INSTANT("reset", typeid(*this).name(), this);
+        std::apply([](auto&... anim) { (detail::reset(anim), ...); }, m_anims);
+    }
+
+    void start_at(Ticks time) override {
+        ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
+        std::apply([&](auto&... anim) { (detail::start_at(anim, time), ...); }, m_anims);
+    }
+
+    [[nodiscard]] double get_progress() const override {
+        double progress = 0.0f;
+        with_longest([&](auto const& anim) { progress = detail::get_progress(anim); });
+        return progress;
+    }
+
+    [[nodiscard]] double get_duration() const override {
+        return to_seconds(get_duration_ticks());
+    }
+
+    [[nodiscard]] Ticks get_duration_ticks() const override {
+        auto fn = [](auto const&... anim) {
+            Ticks duration = Ticks::zero();
+            ((duration = std::max(duration, detail::get_duration_ticks(anim))), ...);
+            return duration;
+        };
+        return std::apply(fn, m_anims);
+    }
+
+    [[nodiscard]] bool is_stopped() const override {
+        bool stopped = false;
+        with_longest([&](auto const& anim) { stopped = detail::is_stopped(anim); });
+        return stopped;
+    }
+
+    [[nodiscard]] bool is_done() const override {
+        bool done = false;
+        with_longest([&](auto const& anim) { done = detail::is_done(anim); });
+        return done;
+    }
+
+    [[nodiscard]] bool is_running() const override {
+        bool running = false;
+        with_longest([&](auto const& anim) { running = detail::is_running(anim); });
+        return running;
+    }
+
+private:
+    // same tie-breaking as Batch: the first of several equally long children
+    template <typename Fn>
+    void with_longest(Fn fn) const {
+        ANIM_PROFILE_COUNT(BatchLongest);
+
+        std::size_t longest = 0;
+        std::size_t index = 0;
+        Ticks max = Ticks::zero();
+
+        auto find = [&](auto const&... anim) {
+            ((detail::get_duration_ticks(anim) > max || index == 0
+              ? (void) (max = detail::get_duration_ticks(anim), longest = index)
+              : void(), ++index), ...);
+        };
+        std::apply(find, m_anims);
+
+        detail::visit_at(m_anims, longest, fn);
+    }
+
+};
+
+// runs animations synchronously
+template <StaticChild... Anims> requires (sizeof...(Anims) > 0)
+class StaticSequence : public IAnimation {
+    static constexpr std::size_t N = sizeof...(Anims);
+
+    std::tuple<Anims&...> m_anims;
+    std::optional<std::size_t> m_current;
+
+public:
+    StaticSequence(Anims&... anims) : m_anims(anims...) { }
+
+    void dispatch() {
+        ANIM_PROFILE_COUNT(SequenceDispatch);
+
+        bool running = m_current.has_value();
+        if (!running) return;
+
+        auto& index = m_current.value();
+
+        bool done = false;
+        detail::visit_at(m_anims, index, [&](auto const& anim) { done = detail::is_done(anim); });
+        if (!done) return;
+
+        detail::visit_at(m_anims, index, [&]([[maybe_unused]] auto const& anim) {
+            ANIM_TRACE_INSTANT("done", typeid(anim).name(), &anim);
+        });
+        index++;
+
+        bool is_at_end = index == N;
+        if (is_at_end) {
+            ANIM_TRACE_INSTANT("done", typeid(*this).name(), this);
+            m_current = { };
+            return;
+        }
+
+        detail::visit_at(m_anims, index, [&](auto& anim) {
+            ANIM_TRACE_INSTANT("dispatch", typeid(anim).name(), &anim);
+            detail::start(anim);
+        });
+    }
+
+    void start() override {
+        ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
+        reset();
+        detail::start(std::get<0>(m_anims));
+        m_current = 0;
+    }
+
+    void start_at(Ticks time) override {
+        ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
+        reset();
+        detail::start_at(std::get<0>(m_anims), time);
+        m_current = 0;
+    }
+
+    void reset() override {
+        ANIM_TRACE_INSTANT("reset", typeid(*this).name(), this);
+        std::apply([](auto&... anim) { (detail::reset(anim), ...); }, m_anims);
+        m_current = { };
+    }
+
+    [[nodiscard]] double get_progress() const override {
+        Ticks time_to_interp = Ticks::zero();
+        double progress_abs = 0.0f;
+        bool found = false;
+
+        auto fn = [&](auto const&... anim) {
+            auto visit = [&](auto const& elem) {
+                if (found) return;
+                Ticks duration = detail::get_duration_ticks(elem);
+                if (detail::is_running(elem)) {
+                    progress_abs = static_cast<double>(time_to_interp.count())
+                                 + detail::get_progress(elem) * static_cast<double>(duration.count());
+                    found = true;
+                    return;
+                }
+                time_to_interp += duration;
+            };
+            (visit(anim), ...);
+        };
+        std::apply(fn, m_anims);
+
+        assert(found);
+        return progress_abs / static_cast<double>(get_duration_ticks().count());
+    }
+
+    [[nodiscard]] double get_duration() const override {
+        return to_seconds(get_duration_ticks());
+    }
+
+    [[nodiscard]] Ticks get_duration_ticks() const override {
+        auto fn = [](auto const&... anim) {
+            return (Ticks::zero() + ... + detail::get_duration_ticks(anim));
+        };
+        return std::apply(fn, m_anims);
+    }
+
+    [[nodiscard]] bool is_stopped() const override {
+        return detail::is_done(std::get<0>(m_anims));
+    }
+
+    [[nodiscard]] bool is_done() const override {
+        return detail::is_done(std::get<N - 1>(m_anims));
+    }
+
+    [[nodiscard]] bool is_running() const override {
+        auto fn = [](auto const&... anim) {
+            return (detail::is_running(anim) || ...);
+        };
+        return std::apply(fn, m_anims);
+    }
+
+};
+
+}
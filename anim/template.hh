@@ -1,11 +1,17 @@
 #pragma once
 
 #include "anim.hh"
+#include "registry.hh"
 
 namespace anim {
 
 
 class AnimationTemplate : public IAnimation {
+    TemplateRegistry* m_registry = nullptr;
+    std::size_t m_registry_index = 0;
+
+    friend class TemplateRegistry;
+
 protected:
     Sequence m_anim;
     AnimationTemplate() = default;
@@ -13,19 +19,36 @@ protected:
     virtual void on_update() { }
 
 public:
+    AnimationTemplate(AnimationTemplate const&) = delete;
+    AnimationTemplate& operator=(AnimationTemplate const&) = delete;
+
+    ~AnimationTemplate() override {
+        if (m_registry) m_registry->remove(*this);
+    }
+
     void update() {
+        ANIM_TRACE_SPAN("update", typeid(*this).name(), this);
         m_anim.dispatch();
-        on_update();
+        {
+            ANIM_TRACE_SPAN("on_update", typeid(*this).name(), this);
+            on_update();
+        }
     }
 
     void start() override {
         m_anim.start();
+        if (m_registry) m_registry->wake(*this);
     }
 
     void reset() override {
         m_anim.reset();
     }
 
+    void start_at(Ticks time) override {
+        m_anim.start_at(time);
+        if (m_registry) m_registry->wake(*this);
+    }
+
     [[nodiscard]] double get_progress() const override {
         return m_anim.get_progress();
     }
@@ -34,6 +57,10 @@ public:
         return m_anim.get_duration();
     }
 
+    [[nodiscard]] Ticks get_duration_ticks() const override {
+        return m_anim.get_duration_ticks();
+    }
+
     [[nodiscard]] bool is_stopped() const override {
         return m_anim.is_stopped();
     }
@@ -0,0 +1,156 @@
+#include <new>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "anim.hh"
+
+// fails if the per-frame paths allocate once a scene is running
+// global operator new is replaced to count allocations, a few frames warm
+// up lazily initialized state, then every allocation is an error
+
+static std::atomic<bool> s_armed = false;
+static std::atomic<std::size_t> s_allocations = 0;
+
+void* operator new(std::size_t size) {
+    if (s_armed.load(std::memory_order_relaxed))
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+// not inlined, gcc would otherwise warn that free() is called on memory
+// from operator new
+[[gnu::noinline]] void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+[[gnu::noinline]] void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+static anim::Ticks s_time { };
+
+static anim::Ticks synthetic_clock() {
+    return s_time;
+}
+
+static constexpr anim::Ticks FRAME = anim::to_ticks(1.0 / 60);
+static constexpr std::size_t WARMUP_FRAMES = 10;
+static constexpr std::size_t FRAMES = 5000;
+static constexpr std::size_t PIXEL_BYTES = 1024 * 1024; // enough for 4 crossfade threads
+
+static constexpr anim::Timeline<float, 3> TIMELINE({
+    { 0, 1, 0.5, anim::interpolators::ease_in_out_cubic },
+    { 1, 1, 0.25 },
+    { 1, 0, 0.5, anim::interpolators::ease_out_back },
+});
+
+class Scene {
+    std::vector<anim::Animation<float>> m_floats;
+    std::vector<anim::Animation<float>> m_steps;
+    std::vector<anim::Sequence> m_sequences;
+    std::vector<anim::TimelineAnimation<float, 3>> m_timelines;
+    std::vector<anim::Animation<float>> m_staggered;
+    anim::World<anim::Animation<float>> m_world;
+    std::vector<std::uint8_t> m_from, m_to, m_pixels;
+    anim::Batch m_batch;
+    std::size_t m_next = 0;
+
+public:
+    Scene(std::size_t count) {
+        m_floats.reserve(count);
+        m_steps.reserve(count * 4);
+        m_sequences.resize(count);
+        m_timelines.reserve(count);
+        m_staggered.reserve(count);
+        m_world.reserve(count);
+        m_from.assign(PIXEL_BYTES, 0);
+        m_to.assign(PIXEL_BYTES, 255);
+        m_pixels.resize(PIXEL_BYTES);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            double duration = 0.5 + (i % 7) / 4.0;
+
+            m_floats.emplace_back(std::initializer_list<anim::Interpolator<float>> {
+                { 0, 1, duration, anim::interpolators::ease_in_out_cubic },
+                { 1, 0, duration },
+            });
+            m_batch.add(m_floats.back());
+
+            for (std::size_t k = 0; k < 4; ++k)
+                m_sequences[i].add(m_steps.emplace_back(anim::Interpolator<float> { 0, 1, duration / 4 }));
+            m_batch.add(m_sequences[i]);
+
+            m_batch.add(m_timelines.emplace_back(TIMELINE));
+            m_staggered.emplace_back(anim::Interpolator<float> { 0, 1, duration });
+        }
+    }
+
+    // restarts the scene once it is done, so starts are covered as well
+    float frame() {
+        if (m_batch.is_stopped() || m_batch.is_done())
+            m_batch.start();
+
+        for (auto& sequence : m_sequences)
+            sequence.dispatch();
+
+        // a few animations start every frame and are dropped once done
+        for (std::size_t i = 0; i < 4; ++i) {
+            m_world.start(m_staggered[m_next]);
+            m_next = (m_next + 1) % m_staggered.size();
+        }
+        m_world.update();
+
+        anim::crossfade(m_from, m_to, m_floats.front().get(), m_pixels, 4);
+
+        float sum = 0.0f;
+        for (auto const& anim : m_floats)
+            sum += anim.get();
+        for (auto const& anim : m_steps)
+            sum += anim.get();
+        for (auto const& anim : m_timelines)
+            sum += anim.get();
+        for (auto const* anim : m_world.get_active())
+            sum += anim->get();
+        return sum + m_pixels[PIXEL_BYTES / 2];
+    }
+};
+
+int main() {
+    anim::set_clock(synthetic_clock);
+
+    Scene scene(256);
+    float sink = 0.0f;
+
+    for (std::size_t i = 0; i < WARMUP_FRAMES + FRAMES; ++i) {
+        if (i == WARMUP_FRAMES)
+            s_armed.store(true, std::memory_order_relaxed);
+
+        s_time += FRAME;
+        sink += scene.frame();
+    }
+
+    s_armed.store(false, std::memory_order_relaxed);
+
+    std::size_t allocations = s_allocations.load(std::memory_order_relaxed);
+    std::printf("%zu allocations in %zu frames (checksum %g)\n", allocations, FRAMES, sink);
+    return allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
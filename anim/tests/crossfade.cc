@@ -0,0 +1,54 @@
+#include <span>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+#include "crossfade.hh"
+
+// the threaded crossfade must match the single threaded one byte for byte,
+// including sizes that do not split evenly across the threads, and output
+// that does not start on a cache line
+
+int main() {
+    static constexpr std::array<std::size_t, 5> sizes = {
+        2 * 1024 * 1024 + 4, // one pixel more than 2 MiB
+        3 * 1024 * 1024 + 1,
+        1024 * 1024 - 63,
+        5 * 256 * 1024 + 17,
+        256 * 1024 * 7,
+    };
+
+    bool ok = true;
+
+    for (std::size_t size : sizes) {
+        std::vector<std::uint8_t> a(size), b(size), single(size), threaded(size + 64);
+        for (std::size_t i = 0; i < size; ++i) {
+            a[i] = static_cast<std::uint8_t>(i * 7);
+            b[i] = static_cast<std::uint8_t>(255 - i * 13);
+        }
+
+        anim::crossfade(a, b, 0.3f, single, 1);
+
+        for (std::size_t offset : { 0, 3, 61 }) {
+            for (unsigned threads : { 2u, 3u, 7u, 8u }) {
+                std::fill(threaded.begin(), threaded.end(), 0);
+                std::span out(threaded.data() + offset, size);
+                anim::crossfade(a, b, 0.3f, out, threads);
+
+                for (std::size_t i = 0; i < size; ++i) {
+                    if (out[i] != single[i]) {
+                        std::printf("size %zu, offset %zu, %u threads: first difference at byte %zu\n",
+                                    size, offset, threads, i);
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,307 @@
+#include "text.hh"
+
+#include <cmath>
+#include <cctype>
+#include <cstdio>
+#include <chrono>
+#include <charconv>
+#include <algorithm>
+
+namespace anim {
+
+namespace text {
+
+namespace {
+
+[[nodiscard]] bool is_word_char(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '+' || c == '-';
+}
+
+[[nodiscard]] bool parse_number(std::string_view word, double& out) {
+    char const* end = word.data() + word.size();
+    auto result = std::from_chars(word.data(), end, out);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// whether seconds fit into Ticks, and into the nanoseconds of the file
+[[nodiscard]] bool is_duration(double seconds) {
+    static double const s_max = std::min(to_seconds(Ticks::max()),
+                                         std::chrono::duration<double>(std::chrono::nanoseconds::max()).count());
+
+    // the maximum rounds up to a power of two as a double, which overflows
+    return std::isfinite(seconds) && seconds >= 0.0 && seconds < s_max;
+}
+
+}
+
+
+bool Parser::feed(std::string_view chunk) {
+    if (!m_error.empty()) return false;
+
+    for (char c : chunk) {
+        if (m_in_comment) {
+            if (c == '\n') {
+                m_in_comment = false;
+                m_line++;
+            }
+            continue;
+        }
+
+        if (is_word_char(c)) {
+            m_word.push_back(c);
+            continue;
+        }
+
+        // a word ending in '-' may have been the start of an arrow
+        if (c == '>' && !m_word.empty() && m_word.back() == '-') {
+            m_word.pop_back();
+            if (!flush_word() || !on_token(Token::Arrow)) return false;
+            continue;
+        }
+
+        if (!flush_word()) return false;
+
+        bool ok = true;
+        switch (c) {
+            case '\n': m_line++; break;
+            case ' ': case '\t': case '\r': break;
+            case '#': m_in_comment = true; break;
+            case '{': ok = on_token(Token::LeftBrace); break;
+            case '}': ok = on_token(Token::RightBrace); break;
+            case '[': ok = on_token(Token::LeftBracket); break;
+            case ']': ok = on_token(Token::RightBracket); break;
+            case ',': ok = on_token(Token::Comma); break;
+            case ';': ok = on_token(Token::Semicolon); break;
+            default: ok = fail("unexpected character", std::string_view(&c, 1)); break;
+        }
+
+        if (!ok) return false;
+    }
+
+    return true;
+}
+
+bool Parser::finish() {
+    if (!m_error.empty() || !flush_word()) return false;
+
+    if (m_state != State::Body || !m_frames.empty())
+        return fail("unexpected end of input");
+
+    if (m_children.empty())
+        return fail("no timeline in input");
+
+    if (m_children.size() == 1)
+        m_writer.set_root(m_children.front());
+    else
+        m_writer.set_root(m_writer.add_batch(m_children));
+
+    m_children.clear();
+    return true;
+}
+
+bool Parser::flush_word() {
+    if (m_word.empty()) return true;
+
+    bool ok = on_token(Token::Word, m_word);
+    m_word.clear(); // keeps the capacity
+    return ok;
+}
+
+bool Parser::on_token(Token token, std::string_view word) {
+    switch (m_state) {
+        case State::Body:
+            if (token == Token::RightBrace) {
+                if (m_frames.empty()) return fail("unmatched '}'");
+                return end_container();
+            }
+
+            if (token != Token::Word) return fail("expected track, batch or sequence", word);
+
+            if (word == "track") m_kind = binary::NodeKind::Track;
+            else if (word == "batch") m_kind = binary::NodeKind::Batch;
+            else if (word == "sequence") m_kind = binary::NodeKind::Sequence;
+            else return fail("expected track, batch or sequence", word);
+
+            m_state = State::NodeBrace;
+            return true;
+
+        case State::NodeBrace:
+            if (token != Token::LeftBrace) return fail("expected '{'", word);
+
+            if (m_kind == binary::NodeKind::Track) {
+                m_components = 0;
+                m_state = State::TrackBody;
+            } else {
+                m_frames.push_back({ m_kind, m_children.size() });
+                m_state = State::Body;
+            }
+            return true;
+
+        case State::TrackBody:
+            if (token == Token::RightBrace) {
+                if (m_components == 0) return fail("a track needs at least one segment");
+                add_child(m_writer.end_track());
+                m_state = State::Body;
+                return true;
+            }
+
+            m_value = 0;
+            return on_value_start(token, word);
+
+        case State::EndValue:
+            m_value = 1;
+            return on_value_start(token, word);
+
+        case State::ValueNumber: {
+            double number;
+            if (token != Token::Word || !parse_number(word, number)) return fail("expected a number", word);
+            if (m_counts[m_value] == binary::MAX_COMPONENTS) return fail("too many components");
+
+            m_values[m_value][m_counts[m_value]++] = static_cast<float>(number);
+            m_state = State::ValueSeparator;
+            return true;
+        }
+
+        case State::ValueSeparator:
+            if (token == Token::Comma) {
+                m_state = State::ValueNumber;
+                return true;
+            }
+            if (token == Token::RightBracket) return on_value_end();
+            return fail("expected ',' or ']'", word);
+
+        case State::Arrow:
+            if (token != Token::Arrow) return fail("expected '->'", word);
+            m_state = State::EndValue;
+            return true;
+
+        case State::Duration:
+            if (token != Token::Word || !parse_number(word, m_duration) || !is_duration(m_duration))
+                return fail("expected a duration", word);
+
+            m_easing = 1; // linear
+            m_state = State::Easing;
+            return true;
+
+        case State::Easing: {
+            if (token == Token::Semicolon) return end_segment();
+            if (token != Token::Word) return fail("expected an easing or ';'", word);
+
+            auto easing = interpolators::find_easing(word);
+            if (!easing) return fail("unknown easing", word);
+
+            m_easing = *easing;
+            m_state = State::Semicolon;
+            return true;
+        }
+
+        case State::Semicolon:
+            if (token != Token::Semicolon) return fail("expected ';'", word);
+            return end_segment();
+    }
+
+    return fail("invalid state");
+}
+
+bool Parser::on_value_start(Token token, std::string_view word) {
+    m_counts[m_value] = 0;
+
+    if (token == Token::LeftBracket) {
+        m_state = State::ValueNumber;
+        return true;
+    }
+
+    double number;
+    if (token != Token::Word || !parse_number(word, number)) return fail("expected a value", word);
+
+    m_values[m_value][0] = static_cast<float>(number);
+    m_counts[m_value] = 1;
+    return on_value_end();
+}
+
+bool Parser::on_value_end() {
+    if (m_counts[m_value] == 0) return fail("empty value");
+
+    m_state = m_value == 0 ? State::Arrow : State::Duration;
+    return true;
+}
+
+bool Parser::end_segment() {
+    if (m_counts[0] != m_counts[1]) return fail("start and end have different numbers of components");
+
+    if (m_components == 0) {
+        m_components = m_counts[0];
+        m_writer.begin_track(m_components);
+    } else if (m_counts[0] != m_components) {
+        return fail("all values of a track need the same number of components");
+    }
+
+    m_writer.add_segment(std::span(m_values[0].data(), m_components),
+                         std::span(m_values[1].data(), m_components),
+                         m_duration,
+                         m_easing);
+
+    m_state = State::TrackBody;
+    return true;
+}
+
+bool Parser::end_container() {
+    Frame frame = m_frames.back();
+    m_frames.pop_back();
+
+    std::span children(m_children.begin() + frame.first_child, m_children.end());
+    if (children.empty()) return fail("a batch or sequence needs at least one child");
+
+    std::uint32_t node = frame.kind == binary::NodeKind::Batch
+        ? m_writer.add_batch(children)
+        : m_writer.add_sequence(children);
+
+    m_children.resize(frame.first_child);
+    add_child(node);
+    return true;
+}
+
+void Parser::add_child(std::uint32_t node) {
+    m_children.push_back(node);
+}
+
+bool Parser::fail(std::string_view message, std::string_view word) {
+    m_error = "line " + std::to_string(m_line) + ": " + std::string(message);
+    if (!word.empty())
+        m_error += ", got '" + std::string(word) + "'";
+    return false;
+}
+
+bool parse_file(char const* path, binary::Writer& writer, std::string* error) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        if (error) *error = std::string("cannot open ") + path;
+        return false;
+    }
+
+    Parser parser(writer);
+    std::vector<char> buffer(64 * 1024);
+    bool ok = true;
+
+    while (ok) {
+        std::size_t read = std::fread(buffer.data(), 1, buffer.size(), file);
+        if (read == 0) break;
+        ok = parser.feed({ buffer.data(), read });
+    }
+
+    bool read_error = std::ferror(file) != 0;
+    std::fclose(file);
+
+    if (ok && read_error) {
+        if (error) *error = std::string("cannot read ") + path;
+        return false;
+    }
+
+    ok = ok && parser.finish();
+    if (!ok && error) *error = parser.get_error();
+    return ok;
+}
+
+}
+
+}
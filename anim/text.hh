@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "binary.hh"
+
+// streaming text format for timelines, compiled into a binary::Writer
+//
+// file      = { node }
+// node      = track | batch | sequence
+// track     = "track" "{" segment { segment } "}"
+// batch     = "batch" "{" node { node } "}"
+// sequence  = "sequence" "{" node { node } "}"
+// segment   = value "->" value duration [ easing ] ";"
+// value     = number | "[" number { "," number } "]"
+// duration  = number, in seconds
+// easing    = a name from interpolators::easings, defaults to linear
+//
+// Whitespace separates tokens and '#' starts a comment that runs to the end
+// of the line. All values of a track have the same number of components, up
+// to 16. With several top level nodes, the root is a batch of all of them.
+//
+// sequence {
+//     batch {
+//         track { 0 -> 10 1 ease_in_out_cubic; 10 -> 20 1; }
+//         track { [0, 0] -> [100, 50] 2 ease_out_back; }
+//     }
+//     track { [0, 0, 0, 255] -> [255, 255, 255, 255] 0.5; }
+// }
+//
+// Input is fed in chunks of any size, so files are parsed without holding
+// them in memory. Nodes go straight into the writer, with no tree in between.
+// The output is not streamed though: binary::Writer keeps the compiled
+// timeline in memory until it is written, about 80% of the size of the text
+// for typical input. Inputs whose compiled form does not fit into memory have
+// to be split into several files.
+
+namespace anim {
+
+namespace text {
+
+class Parser {
+    enum class Token {
+        LeftBrace,
+        RightBrace,
+        LeftBracket,
+        RightBracket,
+        Comma,
+        Semicolon,
+        Arrow,
+        Word,
+    };
+
+    enum class State {
+        Body, // a node or the end of the enclosing batch or sequence
+        NodeBrace, // the brace after a keyword
+        TrackBody, // a segment or the end of the track
+        EndValue, // the value after the arrow
+        ValueNumber, // a number inside brackets
+        ValueSeparator, // a comma or the closing bracket
+        Arrow,
+        Duration,
+        Easing, // an easing or the semicolon
+        Semicolon,
+    };
+
+    struct Frame {
+        binary::NodeKind kind;
+        std::size_t first_child; // in m_children
+    };
+
+    binary::Writer& m_writer;
+
+    // tokenizer
+    std::string m_word; // the word being read, may span chunks
+    bool m_in_comment = false;
+    std::size_t m_line = 1;
+
+    // parser
+    State m_state = State::Body;
+    binary::NodeKind m_kind = binary::NodeKind::Track; // after a keyword
+    std::vector<Frame> m_frames; // open batches and sequences
+    std::vector<std::uint32_t> m_children; // finished nodes, of all open frames
+
+    std::array<std::array<float, binary::MAX_COMPONENTS>, 2> m_values { }; // of the current segment
+    std::array<std::uint32_t, 2> m_counts { };
+    std::size_t m_value = 0; // 0 while reading the start, 1 for the end
+    double m_duration = 0.0f;
+    std::uint32_t m_easing = 1;
+    std::uint32_t m_components = 0; // of the current track, 0 before its first segment
+
+    std::string m_error;
+
+public:
+    explicit Parser(binary::Writer& writer) : m_writer(writer) { }
+
+    // returns false on the first error, see get_error()
+    // the writer is left incomplete then, and should be discarded
+    [[nodiscard]] bool feed(std::string_view chunk);
+
+    // ends the input, and sets the root of the writer
+    [[nodiscard]] bool finish();
+
+    [[nodiscard]] std::string_view get_error() const {
+        return m_error;
+    }
+
+    [[nodiscard]] std::size_t get_line() const {
+        return m_line;
+    }
+
+private:
+    [[nodiscard]] bool flush_word();
+    [[nodiscard]] bool on_token(Token token, std::string_view word = { });
+    [[nodiscard]] bool on_value_start(Token token, std::string_view word);
+    [[nodiscard]] bool on_value_end();
+    [[nodiscard]] bool end_segment();
+    [[nodiscard]] bool end_container();
+    void add_child(std::uint32_t node);
+    [[nodiscard]] bool fail(std::string_view message, std::string_view word = { });
+
+};
+
+// parses a whole file in fixed size chunks
+[[nodiscard]] bool parse_file(char const* path, binary::Writer& writer, std::string* error = nullptr);
+
+}
+
+}
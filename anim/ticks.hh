@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+
+#include "profile.hh"
+
+// time base of the library
+// Time stamps and durations are integer ticks, nanoseconds by default, so
+// elapsed times and comparisons against durations are exact however long the
+// process runs. Seconds as floating point only appear at the edges: durations
+// given by the user, and the one conversion per segment evaluation.
+//
+// Define ANIM_TICKS_PER_SECOND, eg. to 1'000'000 for microseconds. A signed
+// 64-bit count of nanoseconds lasts for 292 years.
+
+#ifndef ANIM_TICKS_PER_SECOND
+#define ANIM_TICKS_PER_SECOND 1'000'000'000
+#endif
+
+namespace anim {
+
+using Ticks = std::chrono::duration<std::int64_t, std::ratio<1, ANIM_TICKS_PER_SECOND>>;
+
+[[nodiscard]] constexpr Ticks to_ticks(double seconds) {
+    return std::chrono::round<Ticks>(std::chrono::duration<double>(seconds));
+}
+
+[[nodiscard]] constexpr double to_seconds(Ticks ticks) {
+    return std::chrono::duration<double>(ticks).count();
+}
+
+using ClockFn = Ticks (*)();
+
+namespace detail {
+
+inline std::atomic<ClockFn> clock = nullptr;
+
+}
+
+// replaces the steady clock, eg. with a synthetic clock that tests and benchmarks
+// advance by hand, nullptr restores the steady clock
+inline void set_clock(ClockFn clock) {
+    detail::clock.store(clock, std::memory_order_relaxed);
+}
+
+// the clock all animations are timed against
+[[nodiscard]] inline Ticks get_time_ticks() {
+    ANIM_PROFILE_COUNT(ClockRead);
+
+    if (ClockFn clock = detail::clock.load(std::memory_order_relaxed))
+        return clock();
+
+    auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<Ticks>(time);
+}
+
+// same, in seconds
+[[nodiscard]] inline double get_time_secs() {
+    return to_seconds(get_time_ticks());
+}
+
+}
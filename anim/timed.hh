@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <optional>
+
+#include "common.hh"
+#include "ticks.hh"
+
+namespace anim {
+
+// clock state of an animation that runs for a fixed duration
+// derived classes only have to provide get_duration()
+// the whole state is a single atomic start time, so start(), reset() and seek()
+// may be called from any thread while another one keeps reading the animation.
+// Every query loads the state once, so it never sees a half applied update.
+// An animation that starts in the future, see start_at() and seek(), is not
+// running yet and holds its start, like one that was just started.
+class TimedAnimation : public IAnimation {
+    static constexpr Ticks::rep s_inactive = std::numeric_limits<Ticks::rep>::min();
+
+    std::atomic<Ticks::rep> m_start_time = s_inactive;
+
+public:
+    TimedAnimation() = default;
+
+    TimedAnimation(TimedAnimation const& other)
+    : m_start_time(other.load_start_time())
+    { }
+
+    TimedAnimation& operator=(TimedAnimation const& other) {
+        m_start_time.store(other.load_start_time(), std::memory_order_release);
+        return *this;
+    }
+
+    void start() override {
+        start_at(get_time_ticks());
+    }
+
+    void start_at(Ticks time) override {
+        ANIM_TRACE_INSTANT("start", typeid(*this).name(), this);
+        m_start_time.store(time.count(), std::memory_order_release);
+    }
+
+    void reset() override {
+        ANIM_TRACE_INSTANT("reset", typeid(*this).name(), this);
+        m_start_time.store(s_inactive, std::memory_order_release);
+    }
+
+    // starts the animation as if start() had been called t ago, or in -t
+    void seek(Ticks t) {
+        seek(t, get_time_ticks());
+    }
+
+    // same, as of the given time
+    void seek(Ticks t, Ticks time) {
+        ANIM_TRACE_INSTANT("seek", typeid(*this).name(), this);
+        m_start_time.store((time - t).count(), std::memory_order_release);
+    }
+
+    // same, t in seconds
+    void seek(double t) {
+        seek(to_ticks(t));
+    }
+
+    [[nodiscard]] double get_progress() const override {
+        auto elapsed = get_elapsed_ticks().value_or(Ticks::zero());
+        return static_cast<double>(elapsed.count()) / static_cast<double>(get_duration_ticks().count());
+    }
+
+    [[nodiscard]] bool is_stopped() const override {
+        return !is_active();
+    }
+
+    [[nodiscard]] bool is_running() const override {
+        auto offset = get_offset(get_time_ticks());
+        return offset && *offset >= Ticks::zero() && *offset <= get_duration_ticks();
+    }
+
+    [[nodiscard]] bool is_done() const override {
+        auto elapsed = get_elapsed_ticks();
+        return elapsed && *elapsed > get_duration_ticks();
+    }
+
+protected:
+    [[nodiscard]] bool is_active() const {
+        return load_start_time() != s_inactive;
+    }
+
+    // time since start(), zero until a start in the future, or nothing if the
+    // animation is not active
+    // derived classes use this instead of is_active() followed by reading the
+    // clock, as the animation may be reset in between
+    [[nodiscard]] std::optional<Ticks> get_elapsed_ticks() const {
+        return get_elapsed_ticks(get_time_ticks());
+    }
+
+    // same, as of the given time
+    [[nodiscard]] std::optional<Ticks> get_elapsed_ticks(Ticks time) const {
+        auto offset = get_offset(time);
+        if (offset && *offset < Ticks::zero()) return Ticks::zero();
+        return offset;
+    }
+
+    // same, in seconds, for curves that are evaluated in seconds
+    [[nodiscard]] std::optional<double> get_elapsed() const {
+        auto elapsed = get_elapsed_ticks();
+        if (!elapsed) return { };
+        return to_seconds(*elapsed);
+    }
+
+private:
+    // time since the start, negative while it is still ahead
+    [[nodiscard]] std::optional<Ticks> get_offset(Ticks time) const {
+        auto start = load_start_time();
+        if (start == s_inactive) return { };
+        return time - Ticks(start);
+    }
+
+    [[nodiscard]] Ticks::rep load_start_time() const {
+        return m_start_time.load(std::memory_order_acquire);
+    }
+
+};
+
+}
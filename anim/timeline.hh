@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <algorithm>
+
+#include "common.hh"
+#include "timed.hh"
+
+namespace anim {
+
+// a fixed list of interpolators that may be defined and evaluated at compile time
+// segment offsets are computed on construction, so a constexpr timeline
+// ends up as a table in read-only memory
+template <Interpolatable T, std::size_t N>
+class Timeline {
+    static_assert(N > 0, "a timeline needs at least one interpolator");
+
+    std::array<Interpolator<T>, N> m_interps;
+    std::array<Ticks, N> m_ends { }; // time at which each interpolator ends
+
+public:
+    constexpr Timeline(Interpolator<T> const (&interps)[N])
+    : m_interps(std::to_array(interps))
+    {
+        Ticks time = Ticks::zero();
+        for (std::size_t i = 0; i < N; ++i) {
+            time += m_interps[i].get_duration_ticks();
+            m_ends[i] = time;
+        }
+    }
+
+    [[nodiscard]] static constexpr std::size_t size() {
+        return N;
+    }
+
+    // in seconds
+    [[nodiscard]] constexpr double get_duration() const {
+        return to_seconds(m_ends.back());
+    }
+
+    [[nodiscard]] constexpr Ticks get_duration_ticks() const {
+        return m_ends.back();
+    }
+
+    // time at which the interpolator at the given index starts
+    [[nodiscard]] constexpr Ticks get_offset(std::size_t index) const {
+        return index == 0 ? Ticks::zero() : m_ends[index - 1];
+    }
+
+    [[nodiscard]] constexpr Interpolator<T> const& operator[](std::size_t index) const {
+        return m_interps[index];
+    }
+
+    [[nodiscard]] constexpr T get_start() const {
+        return m_interps.front().get_start();
+    }
+
+    [[nodiscard]] constexpr T get_end() const {
+        return m_interps.back().get_end();
+    }
+
+    [[nodiscard]] constexpr T get(Ticks t) const {
+        if (t >= get_duration_ticks()) return get_end();
+
+        auto current = std::ranges::lower_bound(m_ends, t);
+        auto index = static_cast<std::size_t>(current - m_ends.begin());
+        return m_interps[index].get(t - get_offset(index));
+    }
+
+    // t in seconds
+    [[nodiscard]] constexpr T get(double t) const {
+        return get(to_ticks(t));
+    }
+
+    // evaluates the timeline at evenly spaced points, including both ends
+    // requires constexpr easing functions when used in a constant expression
+    template <std::size_t Samples> requires (Samples > 1)
+    [[nodiscard]] constexpr std::array<T, Samples> sample() const {
+        std::array<T, Samples> table;
+        for (std::size_t i = 0; i < Samples; ++i) {
+            Ticks t = get_duration_ticks() * static_cast<Ticks::rep>(i) / static_cast<Ticks::rep>(Samples - 1);
+            table[i] = get(t);
+        }
+        return table;
+    }
+
+};
+
+// allows omitting the size: make_timeline<float>({ { 0, 1, 1 }, ... })
+template <Interpolatable T, std::size_t N>
+[[nodiscard]] constexpr Timeline<T, N> make_timeline(Interpolator<T> const (&interps)[N]) {
+    return Timeline<T, N>(interps);
+}
+
+// plays back a timeline that is stored elsewhere, usually as a constexpr static
+template <Interpolatable T, std::size_t N>
+class TimelineAnimation : public TimedAnimation {
+    Timeline<T, N> const& m_timeline;
+
+public:
+    TimelineAnimation(Timeline<T, N> const& timeline) : m_timeline(timeline) { }
+
+    [[nodiscard]] double get_duration() const override {
+        return m_timeline.get_duration();
+    }
+
+    [[nodiscard]] Ticks get_duration_ticks() const override {
+        return m_timeline.get_duration_ticks();
+    }
+
+    [[nodiscard]] T get() const {
+        ANIM_PROFILE_COUNT(AnimationGet);
+
+        auto elapsed = get_elapsed_ticks();
+        if (!elapsed)
+            return m_timeline.get_start();
+
+        return m_timeline.get(*elapsed);
+    }
+
+    operator T() const {
+        return get();
+    }
+
+};
+
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// hierarchical timer wheel
+// time is split into ticks of a fixed resolution. Level 0 has a slot for each
+// of the next 256 ticks, level 1 a slot for each of the next 256 blocks of 256
+// ticks, and so on. Adding and cancelling a timer is O(1). Advancing touches the
+// timers that are due and skips blocks of ticks with nothing due, no matter how
+// many timers are waiting. Timers in a slot of a higher level are moved down a
+// level once the wheel reaches their block, so each one moves at most 3 times.
+// Timers never fire early, and at most one tick late.
+
+namespace anim {
+
+template <typename T>
+class TimerWheel {
+public:
+    using Id = std::uint64_t;
+
+private:
+    static constexpr std::size_t s_levels = 4;
+    static constexpr std::size_t s_bits = 8;
+    static constexpr std::size_t s_slots = 1 << s_bits;
+    static constexpr std::uint64_t s_range = std::uint64_t(1) << (s_bits * s_levels);
+    static constexpr std::uint32_t s_none = std::numeric_limits<std::uint32_t>::max();
+
+    struct Node {
+        T value;
+        std::uint64_t expiry = 0; // tick
+        std::uint32_t next = s_none;
+        std::uint32_t prev = s_none;
+        std::uint32_t generation = 0;
+        std::uint32_t slot = s_none; // level * s_slots + index, s_none if unused
+    };
+
+    struct Slot {
+        std::uint32_t head = s_none;
+        std::uint32_t tail = s_none;
+    };
+
+    std::vector<Node> m_nodes;
+    std::uint32_t m_free = s_none; // free nodes, linked through next
+    std::array<Slot, s_levels * s_slots> m_slots { };
+    std::array<std::size_t, s_levels> m_level_sizes { };
+    std::size_t m_size = 0;
+
+    double m_origin;
+    double m_resolution;
+    std::uint64_t m_current = 0; // last tick that was processed
+
+public:
+    // resolution is the length of a tick in seconds
+    explicit TimerWheel(double origin, double resolution = 0.001)
+    : m_origin(origin)
+    , m_resolution(resolution)
+    {
+        assert(resolution > 0.0f);
+    }
+
+    // fires at the first advance() to a time at or after the given one,
+    // times that already passed fire on the next tick
+    Id add(double time, T value) {
+        std::uint32_t index = allocate();
+        Node& node = m_nodes[index];
+        node.value = std::move(value);
+        node.expiry = std::max(to_tick(time), m_current + 1);
+
+        link(index);
+        m_size++;
+        return (std::uint64_t(node.generation) << 32) | index;
+    }
+
+    // returns false if the timer already fired or was cancelled
+    bool cancel(Id id) {
+        auto index = static_cast<std::uint32_t>(id);
+        auto generation = static_cast<std::uint32_t>(id >> 32);
+
+        if (index >= m_nodes.size()) return false;
+        Node& node = m_nodes[index];
+        if (node.generation != generation || node.slot == s_none) return false;
+
+        unlink(index);
+        release(index);
+        m_size--;
+        return true;
+    }
+
+    // calls fn(T) for every timer that is due at the given time, in order of expiry
+    // fn may add and cancel timers
+    template <typename Fn>
+    void advance(double now, Fn fn) {
+        std::uint64_t target = to_tick_floor(now);
+
+        while (m_current < target) {
+            // nothing is due before the end of a block when all lower levels are empty
+            std::size_t empty = 0;
+            while (empty < s_levels && m_level_sizes[empty] == 0)
+                empty++;
+
+            if (empty > 0) {
+                std::uint64_t block_end = m_current | ((std::uint64_t(1) << (s_bits * empty)) - 1);
+                if (block_end > m_current) {
+                    m_current = std::min(block_end, target);
+                    continue;
+                }
+            }
+
+            m_current++;
+            cascade();
+            fire(m_current & (s_slots - 1), fn);
+        }
+    }
+
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        for (auto const& node : m_nodes)
+            if (node.slot != s_none)
+                fn(node.value);
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_size;
+    }
+
+    [[nodiscard]] double get_resolution() const {
+        return m_resolution;
+    }
+
+private:
+    // first tick at or after time
+    [[nodiscard]] std::uint64_t to_tick(double time) const {
+        double ticks = std::ceil((time - m_origin) / m_resolution);
+        if (!(ticks > 0.0f)) return 0;
+        return static_cast<std::uint64_t>(ticks);
+    }
+
+    // last tick at or before time
+    [[nodiscard]] std::uint64_t to_tick_floor(double time) const {
+        double ticks = std::floor((time - m_origin) / m_resolution);
+        if (!(ticks > 0.0f)) return 0;
+        return static_cast<std::uint64_t>(ticks);
+    }
+
+    [[nodiscard]] std::uint32_t allocate() {
+        if (m_free == s_none) {
+            m_nodes.emplace_back();
+            return static_cast<std::uint32_t>(m_nodes.size() - 1);
+        }
+
+        std::uint32_t index = m_free;
+        m_free = m_nodes[index].next;
+        return index;
+    }
+
+    void release(std::uint32_t index) {
+        Node& node = m_nodes[index];
+        node.value = T { };
+        node.generation++;
+        node.slot = s_none;
+        node.next = m_free;
+        m_free = index;
+    }
+
+    void link(std::uint32_t index) {
+        Node& node = m_nodes[index];
+        std::uint64_t delta = node.expiry - m_current;
+
+        // timers beyond the range of the wheel wait in the last block of the
+        // top level, and are placed again once it is reached
+        std::uint64_t expiry = delta < s_range ? node.expiry : m_current + s_range - 1;
+        if (delta >= s_range) delta = s_range - 1;
+
+        std::size_t level = 0;
+        while (delta >= (std::uint64_t(1) << (s_bits * (level + 1))))
+            level++;
+
+        std::size_t slot_index = level * s_slots + ((expiry >> (s_bits * level)) & (s_slots - 1));
+        Slot& slot = m_slots[slot_index];
+
+        node.slot = static_cast<std::uint32_t>(slot_index);
+        m_level_sizes[level]++;
+        node.next = s_none;
+        node.prev = slot.tail;
+
+        if (slot.tail == s_none)
+            slot.head = index;
+        else
+            m_nodes[slot.tail].next = index;
+        slot.tail = index;
+    }
+
+    void unlink(std::uint32_t index) {
+        Node& node = m_nodes[index];
+        Slot& slot = m_slots[node.slot];
+        m_level_sizes[node.slot / s_slots]--;
+
+        if (node.prev == s_none) slot.head = node.next;
+        else m_nodes[node.prev].next = node.next;
+
+        if (node.next == s_none) slot.tail = node.prev;
+        else m_nodes[node.next].prev = node.prev;
+    }
+
+    // moves the timers of every level whose block starts at the current tick
+    // down, starting at the top so they can fall through several levels
+    void cascade() {
+        for (std::size_t level = s_levels - 1; level > 0; --level) {
+            std::uint64_t mask = (std::uint64_t(1) << (s_bits * level)) - 1;
+            if ((m_current & mask) != 0) continue;
+
+            std::size_t slot_index = level * s_slots + ((m_current >> (s_bits * level)) & (s_slots - 1));
+            std::uint32_t index = std::exchange(m_slots[slot_index], Slot { }).head;
+
+            while (index != s_none) {
+                std::uint32_t next = m_nodes[index].next;
+                m_level_sizes[level]--;
+                link(index);
+                index = next;
+            }
+        }
+    }
+
+    template <typename Fn>
+    void fire(std::size_t slot_index, Fn& fn) {
+        // one at a time, as fn may cancel the timers that follow
+        // new timers never land in the slot of the current tick
+        while (m_slots[slot_index].head != s_none) {
+            std::uint32_t index = m_slots[slot_index].head;
+            unlink(index);
+
+            T value = std::move(m_nodes[index].value);
+            release(index);
+            m_size--;
+            fn(std::move(value));
+        }
+    }
+
+};
+
+}
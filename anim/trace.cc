@@ -0,0 +1,164 @@
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define ANIM_TRACE_DEMANGLE
+#endif
+
+#include "trace.hh"
+
+namespace anim {
+
+namespace trace {
+
+namespace detail {
+
+std::atomic<bool> g_enabled = false;
+
+}
+
+namespace {
+
+constexpr std::uint64_t buffer_capacity = 1 << 15;
+
+// single producer ring, only ever written by its owning thread
+struct Buffer {
+    std::array<Event, buffer_capacity> events;
+    std::atomic<std::uint64_t> head = 0;
+    std::atomic<std::uint64_t> first = 0;
+    int thread_id;
+
+    explicit Buffer(int thread_id) : thread_id(thread_id) { }
+};
+
+std::mutex g_mutex;
+
+// buffers are never freed, so events of exited threads can still be exported
+std::vector<std::unique_ptr<Buffer>> g_buffers;
+
+[[nodiscard]] Buffer& local_buffer() {
+    thread_local Buffer* buffer = [] {
+        std::scoped_lock lock(g_mutex);
+        int id = static_cast<int>(g_buffers.size()) + 1;
+        return g_buffers.emplace_back(std::make_unique<Buffer>(id)).get();
+    }();
+    return *buffer;
+}
+
+// as the contents of a json string, type names may contain quotes and backslashes
+void write_escaped(std::ostream& os, char const* text) {
+    static constexpr char s_hex[] = "0123456789abcdef";
+
+    for (; *text != '\0'; ++text) {
+        auto c = static_cast<unsigned char>(*text);
+        switch (c) {
+            case '"':  os << "\\\""; break;
+            case '\\': os << "\\\\"; break;
+            case '\n': os << "\\n"; break;
+            case '\r': os << "\\r"; break;
+            case '\t': os << "\\t"; break;
+            default:
+                if (c < 0x20)
+                    os << "\\u00" << s_hex[c >> 4] << s_hex[c & 0xf];
+                else
+                    os << static_cast<char>(c);
+        }
+    }
+}
+
+void write_label(std::ostream& os, char const* label) {
+#ifdef ANIM_TRACE_DEMANGLE
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(label, nullptr, nullptr, &status);
+    if (status == 0) {
+        write_escaped(os, demangled);
+        std::free(demangled);
+        return;
+    }
+#endif
+    write_escaped(os, label);
+}
+
+void write_event(std::ostream& os, Event const& event, int thread_id) {
+    os << "{\"name\":\"";
+    write_escaped(os, event.name);
+    os << "\",\"cat\":\"";
+    write_label(os, event.label);
+    os << "\",\"ph\":\"" << static_cast<char>(event.phase) << "\""
+       << ",\"ts\":" << event.timestamp / 1000.0;
+
+    if (event.phase == Phase::Complete)
+        os << ",\"dur\":" << event.duration / 1000.0;
+    else
+        os << ",\"s\":\"t\"";
+
+    os << ",\"pid\":1,\"tid\":" << thread_id
+       << ",\"args\":{\"object\":\"" << event.object << "\"}}";
+}
+
+}
+
+[[nodiscard]] std::int64_t now() {
+    namespace chrono = std::chrono;
+    auto time = chrono::steady_clock::now().time_since_epoch();
+    return chrono::duration_cast<chrono::nanoseconds>(time).count();
+}
+
+void record(Event const& event) {
+    Buffer& buffer = local_buffer();
+    std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % buffer_capacity] = event;
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void write_chrome_json(std::ostream& os) {
+    std::scoped_lock lock(g_mutex);
+
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+
+    os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first_event = true;
+
+    for (auto const& buffer : g_buffers) {
+        std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        std::uint64_t oldest = head > buffer_capacity ? head - buffer_capacity : 0;
+        std::uint64_t first = std::max(oldest, buffer->first.load(std::memory_order_relaxed));
+
+        for (std::uint64_t i = first; i < head; ++i) {
+            if (!first_event) os << ",\n";
+            first_event = false;
+            write_event(os, buffer->events[i % buffer_capacity], buffer->thread_id);
+        }
+    }
+
+    os << "]}\n";
+    os.flags(flags);
+    os.precision(precision);
+}
+
+[[nodiscard]] bool write_chrome_json(char const* path) {
+    std::ofstream file(path);
+    if (!file) return false;
+    write_chrome_json(file);
+    return static_cast<bool>(file);
+}
+
+void clear() {
+    std::scoped_lock lock(g_mutex);
+    for (auto const& buffer : g_buffers)
+        buffer->first.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+
+}
+
+}
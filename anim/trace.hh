@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <ostream>
+
+// lifecycle and evaluation tracing, exported as chrome trace json
+// (open in https://ui.perfetto.dev or chrome://tracing)
+// tracing is compiled in by defining ANIM_TRACE (see the TRACE cmake option),
+// and has to be switched on at runtime via anim::trace::enable()
+
+namespace anim {
+
+namespace trace {
+
+enum class Phase : char {
+    Instant  = 'i',
+    Complete = 'X',
+};
+
+struct Event {
+    char const* name;
+    char const* label; // type of the traced object, may be mangled
+    void const* object;
+    std::int64_t timestamp; // ns
+    std::int64_t duration;  // ns, only for Phase::Complete
+    Phase phase;
+};
+
+namespace detail {
+
+extern std::atomic<bool> g_enabled;
+
+}
+
+inline void enable(bool enabled = true) {
+    detail::g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+[[nodiscard]] inline bool is_enabled() {
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+[[nodiscard]] std::int64_t now();
+
+// appends to the calling thread's buffer, which keeps the most recent events
+void record(Event const& event);
+
+inline void instant(char const* name, char const* label, void const* object) {
+    record({ name, label, object, now(), 0, Phase::Instant });
+}
+
+// records a complete event for the lifetime of the span
+class Span {
+    char const* m_name;
+    char const* m_label;
+    void const* m_object;
+    std::int64_t m_start;
+
+public:
+    Span(char const* name, char const* label, void const* object)
+        : m_name(name)
+        , m_label(label)
+        , m_object(object)
+        , m_start(is_enabled() ? now() : -1)
+    { }
+
+    Span(Span const&) = delete;
+    Span& operator=(Span const&) = delete;
+
+    ~Span() {
+        if (m_start == -1) return;
+        std::int64_t end = now();
+        record({ m_name, m_label, m_object, m_start, end - m_start, Phase::Complete });
+    }
+
+};
+
+// writes the events of all threads; threads that keep recording
+// during the export may overwrite events that are being written out
+void write_chrome_json(std::ostream& os);
+[[nodiscard]] bool write_chrome_json(char const* path);
+
+// drops all recorded events
+void clear();
+
+}
+
+}
+
+#ifdef ANIM_TRACE
+
+#define ANIM_TRACE_CONCAT_IMPL(a, b) a##b
+#define ANIM_TRACE_CONCAT(a, b) ANIM_TRACE_CONCAT_IMPL(a, b)
+
+#define ANIM_TRACE_INSTANT(name, label, object)                 \
+    do {                                                        \
+        if (::anim::trace::is_enabled())                        \
+            ::anim::trace::instant((name), (label), (object));  \
+    } while (0)
+
+#define ANIM_TRACE_SPAN(name, label, object) \
+    ::anim::trace::Span ANIM_TRACE_CONCAT(anim_trace_span_, __LINE__) { (name), (label), (object) }
+
+#else
+
+#define ANIM_TRACE_INSTANT(name, label, object) ((void) 0)
+#define ANIM_TRACE_SPAN(name, label, object) ((void) 0)
+
+#endif // ANIM_TRACE
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <bit>
+#include <span>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <concepts>
+#include <algorithm>
+
+#include "common.hh"
+
+namespace anim {
+
+// the set of running animations
+// active animations are kept in a dense array, that animations are appended to
+// when they start and swap-removed from once they are done. Walking the active
+// set costs the same no matter how many idle animations exist.
+// With A set to a concrete type, eg. World<Animation<float>>, values can be read
+// from the active set without going through IAnimation.
+// The position of each animation in the active set is found through a flat
+// open addressing table, so starting and stopping animations never allocates
+// once the world has been reserved for as many as run at a time.
+template <std::derived_from<IAnimation> A = IAnimation>
+class World {
+    struct Slot {
+        A const* anim = nullptr; // empty if null
+        std::uint32_t index = 0; // position in m_active
+    };
+
+    std::vector<A*> m_active;
+    std::vector<Slot> m_slots; // linear probing, a power of two, at most half full
+
+public:
+    void reserve(std::size_t count) {
+        m_active.reserve(count);
+        if (count * 2 > m_slots.size())
+            rehash(std::bit_ceil(count * 2));
+    }
+
+    // starts the animation, or restarts it if it is already active
+    void start(A& anim) {
+        anim.start();
+        insert(anim);
+    }
+
+    void start_at(A& anim, Ticks time) {
+        anim.start_at(time);
+        insert(anim);
+    }
+
+    // tracks an animation that was started elsewhere
+    void add(A& anim) {
+        insert(anim);
+    }
+
+    // resets the animation and drops it from the active set
+    void reset(A& anim) {
+        anim.reset();
+        remove(anim);
+    }
+
+    // drops the animations that are done, returns how many were dropped
+    std::size_t update() {
+        std::size_t dropped = 0;
+
+        for (std::size_t i = 0; i < m_active.size();) {
+            A* anim = m_active[i];
+
+            if (!anim->is_done()) {
+                i++;
+                continue;
+            }
+
+            ANIM_TRACE_INSTANT("done", typeid(*anim).name(), anim);
+            remove_at(i);
+            dropped++;
+        }
+
+        return dropped;
+    }
+
+    [[nodiscard]] std::span<A* const> get_active() const {
+        return m_active;
+    }
+
+    [[nodiscard]] bool is_active(A const& anim) const {
+        return !m_slots.empty() && m_slots[find(&anim)].anim != nullptr;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return m_active.size();
+    }
+
+private:
+    void insert(A& anim) {
+        if ((m_active.size() + 1) * 2 > m_slots.size())
+            rehash(std::max<std::size_t>(m_slots.size() * 2, 16));
+
+        Slot& slot = m_slots[find(&anim)];
+        if (slot.anim != nullptr) return;
+
+        slot = { &anim, static_cast<std::uint32_t>(m_active.size()) };
+        m_active.push_back(&anim);
+    }
+
+    void remove(A const& anim) {
+        if (m_slots.empty()) return;
+
+        Slot const& slot = m_slots[find(&anim)];
+        if (slot.anim != nullptr)
+            remove_at(slot.index);
+    }
+
+    // moves the last animation into the gap
+    void remove_at(std::size_t index) {
+        assert(index < m_active.size());
+
+        A* last = m_active.back();
+        erase(find(m_active[index]));
+
+        if (last != m_active[index]) {
+            m_active[index] = last;
+            m_slots[find(last)].index = static_cast<std::uint32_t>(index);
+        }
+
+        m_active.pop_back();
+    }
+
+    [[nodiscard]] std::size_t get_home(A const* anim) const {
+        // fibonacci hashing, the low bits of pointers are mostly zero
+        auto bits = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(anim));
+        return static_cast<std::size_t>((bits * 0x9e3779b97f4a7c15ull) >> 32) & (m_slots.size() - 1);
+    }
+
+    // the slot of the animation, or the empty slot where it would go
+    [[nodiscard]] std::size_t find(A const* anim) const {
+        std::size_t mask = m_slots.size() - 1;
+        std::size_t i = get_home(anim);
+
+        while (m_slots[i].anim != nullptr && m_slots[i].anim != anim)
+            i = (i + 1) & mask;
+
+        return i;
+    }
+
+    // shifts the following slots back, so lookups never stop at a gap early
+    void erase(std::size_t i) {
+        std::size_t mask = m_slots.size() - 1;
+        m_slots[i] = { };
+
+        for (std::size_t j = (i + 1) & mask; m_slots[j].anim != nullptr; j = (j + 1) & mask) {
+            // distances from the home slot, a slot may move back to i if it
+            // is no further from home than i is
+            std::size_t home = get_home(m_slots[j].anim);
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                m_slots[i] = m_slots[j];
+                m_slots[j] = { };
+                i = j;
+            }
+        }
+    }
+
+    void rehash(std::size_t size) {
+        m_slots.assign(size, { });
+        for (std::size_t i = 0; i < m_active.size(); ++i)
+            m_slots[find(m_active[i])] = { m_active[i], static_cast<std::uint32_t>(i) };
+    }
+
+};
+
+}
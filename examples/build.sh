@@ -1,12 +1,13 @@
 #!/bin/sh
 set -euo pipefail
 
-if [[ $# != 1 ]]; then
-    echo "Usage: $0 <web|native>" 1>&2
+if [[ $# -lt 1 ]]; then
+    echo "Usage: $0 <web|native|stress> [stress args...]" 1>&2
     exit 1
 fi
 
 build_type=$1
+shift
 anim=../anim
 cflags="-Wall -Wextra -std=c++23 -pedantic -O3"
 libs="-I$anim -L$anim/build -lanim -lraylib"
@@ -38,6 +39,14 @@ build_native() {
     rm ./example
 }
 
+# headless, only needs the raylib headers for its vector types
+build_stress() {
+    raylib=./raylib-5.5_webassembly/
+    clang++ stress.cc $cflags -I$anim -L$anim/build -lanim -I$raylib/include -o stress
+    ./stress "$@"
+    rm ./stress
+}
+
 case $build_type in
     "web")
         build_library $build_type
@@ -47,8 +56,12 @@ case $build_type in
         build_library $build_type
         build_native
         ;;
+    "stress")
+        build_library native
+        build_stress "$@"
+        ;;
     *)
-        echo "Invalid build type, try <web|native>" 1>&2
+        echo "Invalid build type, try <web|native|stress>" 1>&2
         exit 1
         ;;
 esac
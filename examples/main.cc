@@ -41,7 +41,7 @@ class LoadingBarAnimation : public anim::AnimationTemplate {
     anim::Animation<Rectangle> m_rect = init_rect();
     anim::Animation<Color> m_anim_color_end = init_anim_color_end();
 
-    anim::Batch m_box { m_roundness, m_rect };
+    anim::StaticBatch<anim::Animation<float>, anim::Animation<Rectangle>> m_box { m_roundness, m_rect };
 
 public:
     LoadingBarAnimation(Vector2 center, float width, float thickness, float height,
@@ -77,8 +77,10 @@ public:
 private:
     void draw_percentage() const {
         double perc = m_pos.is_running() ? 0 : std::trunc(m_bar_width.get_progress()*100);
-        auto text = std::format("{}%", perc);
-        draw_text_centered(m_pos, m_font, text.c_str(), 50);
+        // formatted into a stack buffer, as this runs every frame
+        std::array<char, 8> text { };
+        std::format_to_n(text.data(), text.size() - 1, "{}%", perc);
+        draw_text_centered(m_pos, m_font, text.data(), 50);
     }
 
     void draw_inner_bar(Vector2 start) const {
@@ -131,8 +133,15 @@ private:
 class RotatingSquareAnimation : public anim::AnimationTemplate {
     float m_square_size = 300;
 
+    // fully known at compile time, so it lives in read-only memory
+    static constexpr auto s_rotation = anim::make_timeline<float>({
+        anim::Interpolator<float>::wait(0, 1),
+        { 0, 180, 2, anim::interpolators::ease_in_out_back },
+        anim::Interpolator<float>::wait(0, 1),
+    });
+
     anim::Animation<Vector2> m_pos = init_pos();
-    anim::Animation<float> m_rotation = init_rotation();
+    anim::TimelineAnimation<float, s_rotation.size()> m_rotation { s_rotation };
     anim::Batch m_batch { m_pos, m_rotation };
 
 public:
@@ -149,14 +158,6 @@ public:
     }
 
 private:
-    [[nodiscard]] constexpr anim::Animation<float> init_rotation() {
-        return {
-            anim::Interpolator<float>::wait(0, 1),
-            { 0, 180, 2, anim::interpolators::ease_in_out_back },
-            anim::Interpolator<float>::wait(0, 1),
-        };
-    }
-
     [[nodiscard]] constexpr anim::Animation<Vector2> init_pos() {
         float y = HEIGHT/2.0f;
         Vector2 middle = {WIDTH/2.0f, y};
@@ -178,44 +179,40 @@ class SquareCircleLineAnimation : public anim::AnimationTemplate {
     float m_radius = m_square_size/2;
     int m_middle_spacing = 20;
 
-    anim::Animation<float> square1 { { 0, m_end-m_radius-m_middle_spacing, 0.5f, anim::interpolators::ease_in_out_cubic } };
-    anim::Animation<float> square2 { { 0, m_end-m_radius-m_middle_spacing, 1.0f, anim::interpolators::ease_in_out_cubic } };
-    anim::Animation<float> square3 { { 0, m_end-m_radius-m_middle_spacing, 1.5f, anim::interpolators::ease_in_out_cubic } };
+    // the squares and the circles each share one curve, and only differ in duration
+    anim::InstancedTrack<float> m_squares { { 0, 1, 0.5f, anim::interpolators::ease_in_out_cubic } };
+    anim::InstancedTrack<float> m_circles { { 0, 1, 0.5f, anim::interpolators::ease_in_out_cubic } };
 
-    anim::Animation<float> circle1 { { static_cast<float>(WIDTH-m_radius), m_end+m_radius+m_middle_spacing, 0.5f, anim::interpolators::ease_in_out_cubic } };
-    anim::Animation<float> circle2 { { static_cast<float>(WIDTH-m_radius), m_end+m_radius+m_middle_spacing, 1.0f, anim::interpolators::ease_in_out_cubic } };
-    anim::Animation<float> circle3 { { static_cast<float>(WIDTH-m_radius), m_end+m_radius+m_middle_spacing, 1.5f, anim::interpolators::ease_in_out_cubic } };
-
-    anim::Animation<float> line1 {
-        { HEIGHT/2.0f, HEIGHT, 0.5f, anim::interpolators::ease_in_quad },
-        { HEIGHT, HEIGHT/2.0f, 0.5f, anim::interpolators::ease_in_quad },
-    };
-
-    anim::Animation<float> line2 {
-        { HEIGHT/2.0f, 0, 0.5f, anim::interpolators::ease_in_quad },
-        { 0, HEIGHT/2.0f, 0.5f, anim::interpolators::ease_in_quad },
+    // both lines move out and back in
+    anim::InstancedTrack<float> m_lines {
+        { 0, 1, 0.5f, anim::interpolators::ease_in_quad },
+        { 1, 0, 0.5f, anim::interpolators::ease_in_quad },
     };
 
-    anim::Batch m_squares { square1, square2, square3 };
-    anim::Batch m_circles { circle1, circle2, circle3 };
-    anim::Batch m_lines { line1, line2 };
-
 public:
-    SquareCircleLineAnimation() : anim::AnimationTemplate({ m_squares, m_circles, m_lines }) { }
+    SquareCircleLineAnimation() : anim::AnimationTemplate({ m_squares, m_circles, m_lines }) {
+        for (float scale : { 1, 2, 3 }) {
+            m_squares.add(0, m_end-m_radius-m_middle_spacing, 0, scale);
+            m_circles.add(WIDTH-m_radius, m_end+m_radius+m_middle_spacing, 0, scale);
+        }
+
+        m_lines.add(HEIGHT/2.0f, HEIGHT);
+        m_lines.add(HEIGHT/2.0f, 0);
+    }
 
     void on_update() override {
 
         if (m_anim.is_running()) {
-            DrawRectanglePro({ square1, HEIGHT/2.0f-m_radius*3, m_square_size, m_square_size }, { m_radius, m_radius }, 0.0f, BLUE);
-            DrawRectanglePro({ square2, HEIGHT/2.0f, m_square_size, m_square_size }, { m_radius, m_radius }, 0.0f, BLUE);
-            DrawRectanglePro({ square3, HEIGHT/2.0f+m_radius*3, m_square_size, m_square_size }, { m_radius, m_radius }, 0.0f, BLUE);
+            DrawRectanglePro({ m_squares.get(0), HEIGHT/2.0f-m_radius*3, m_square_size, m_square_size }, { m_radius, m_radius }, 0.0f, BLUE);
+            DrawRectanglePro({ m_squares.get(1), HEIGHT/2.0f, m_square_size, m_square_size }, { m_radius, m_radius }, 0.0f, BLUE);
+            DrawRectanglePro({ m_squares.get(2), HEIGHT/2.0f+m_radius*3, m_square_size, m_square_size }, { m_radius, m_radius }, 0.0f, BLUE);
 
-            DrawCircle(circle1, HEIGHT/2.0f-m_radius*3, m_radius, RED);
-            DrawCircle(circle2, HEIGHT/2.0f, m_radius, RED);
-            DrawCircle(circle3, HEIGHT/2.0f+m_radius*3, m_radius, RED);
+            DrawCircle(m_circles.get(0), HEIGHT/2.0f-m_radius*3, m_radius, RED);
+            DrawCircle(m_circles.get(1), HEIGHT/2.0f, m_radius, RED);
+            DrawCircle(m_circles.get(2), HEIGHT/2.0f+m_radius*3, m_radius, RED);
         }
 
-        DrawLineEx({ m_end, line1 }, { m_end, line2 }, m_middle_spacing, PURPLE);
+        DrawLineEx({ m_end, m_lines.get(0) }, { m_end, m_lines.get(1) }, m_middle_spacing, PURPLE);
     }
 
 };
@@ -228,31 +225,23 @@ class BouncingCirclesAnimation : public anim::AnimationTemplate {
     const float m_start = HEIGHT/2.0f - m_offset;
     const float m_end = HEIGHT/2.0f + m_offset;
 
-    std::vector<anim::Animation<float>> m_circles;
-    anim::Batch m_batch;
+    // one shared curve, the circles only differ in duration
+    anim::InstancedTrack<float> m_circles { { 0, 1, 1, anim::interpolators::ease_in_out_back } };
+    std::vector<float> m_positions;
 
 public:
     BouncingCirclesAnimation(int count, int radius)
-        : anim::AnimationTemplate(m_batch)
+        : anim::AnimationTemplate(m_circles)
         , m_count(count)
         , m_radius(radius)
+        , m_positions(count)
     {
         assert(m_count % 2 != 0 && "count must be odd");
 
         for (double i=1; i <= m_count; ++i) {
-
             double duration = i < m_count/2.0f ? i : m_count-i+1;
-            auto &anim = m_circles.emplace_back(anim::Animation<float> {
-                { m_start, m_end, duration/2.0f, anim::interpolators::ease_in_out_back },
-            });
-
-            anim.start();
+            m_circles.add(m_start, m_end, 0, duration/2.0f);
         }
-
-        for (auto& anim : m_circles)
-            m_batch.add(anim);
-
-        m_batch.start();
     }
 
     void on_update() override {
@@ -263,12 +252,14 @@ public:
         auto width = m_count * spacing - spacing;
         auto offset = WIDTH/2.0f - width/2.0f;
 
+        m_circles.get(m_positions);
+
         std::size_t idx = 0; // std::views::enumerate() not supported by emscripten em++ :(
-        for (auto &anim : m_circles) {
+        for (float y : m_positions) {
             float x0 = offset + spacing * idx;
 
             DrawLineEx({x0, m_start}, {x0, m_end}, 5, GRAY);
-            DrawCircleV({x0, anim}, m_radius, BLUE);
+            DrawCircleV({x0, y}, m_radius, BLUE);
             idx++;
 
         }
@@ -287,6 +278,13 @@ int main() {
     SquareCircleLineAnimation scl;
     BouncingCirclesAnimation bc(9, 25);
 
+    // only the templates that are playing get updated, in this order
+    anim::TemplateRegistry templates;
+    templates.add(loading_bar, 0);
+    templates.add(rot, 1);
+    templates.add(scl, 2);
+    templates.add(bc, 3);
+
     anim::Sequence seq { loading_bar, bc, scl, rot };
     seq.start();
 
@@ -297,10 +295,7 @@ int main() {
 
         seq.dispatch();
 
-        loading_bar.update();
-        rot.update();
-        scl.update();
-        bc.update();
+        templates.update();
 
         if (seq.is_done())
             seq.start();
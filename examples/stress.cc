@@ -0,0 +1,454 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <raylib.h>
+#include <raymath.h>
+
+#define ANIM_INTEGRATION_RAYLIB
+#include "anim.hh"
+
+// headless stress test, drives large scenes with a synthetic clock and
+// reports the cost per animation and frame
+//
+// usage: stress [flat|tree|vector2|instanced|world|spline|keys|quantized|half] [animations] [frames]
+//        stress parse [megabytes]
+//
+// flat:      a Batch of Animation<float>
+// tree:      a Batch of Sequences of 8 animations each, half of them Animation<Vector2>
+// vector2:   a Batch of Animation<Vector2>
+// instanced: an InstancedTrack<float> with one instance per animation
+// world:     Animation<float> of which about 5% run at a time, tracked by a World
+// spline:    SplineAnimation<Vector2> through 16 keys each, as for camera paths
+// keys:      Animation<float> of 64 linear keys each, over about 10 seconds
+// quantized: the same tracks as QuantizedAnimation<float>, with unorm16 values
+// half:      same, with half float values
+// parse:     streams generated timeline text through text::Parser in 64 KiB chunks
+
+static anim::Ticks s_time { };
+
+static anim::Ticks synthetic_clock() {
+    return s_time;
+}
+
+static constexpr double FRAME = 1.0f / 60;
+static constexpr anim::Ticks FRAME_TICKS = anim::to_ticks(FRAME);
+static constexpr std::size_t SEQUENCE_LENGTH = 8;
+
+using Easing = float (*)(float);
+
+static constexpr std::array<Easing, 4> EASINGS = {
+    anim::interpolators::linear,
+    anim::interpolators::ease_in_out_cubic,
+    anim::interpolators::ease_out_back,
+    anim::interpolators::ease_in_out_expo,
+};
+
+// 0.5s to 4.5s, so animations finish at different frames
+[[nodiscard]] static double get_duration(std::size_t index) {
+    return 0.5f + (index % 97) / 24.0f;
+}
+
+[[nodiscard]] static Easing get_easing(std::size_t index) {
+    return EASINGS[index % EASINGS.size()];
+}
+
+[[nodiscard]] static double now_ms() {
+    namespace chrono = std::chrono;
+    auto time = chrono::steady_clock::now().time_since_epoch();
+    return chrono::duration_cast<chrono::duration<double, std::milli>>(time).count();
+}
+
+[[nodiscard]] static double get_peak_rss_mib() {
+    rusage usage { };
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0f; // KiB on linux
+}
+
+class Scene {
+public:
+    virtual void start() = 0;
+    virtual float frame() = 0;
+    virtual ~Scene() = default;
+};
+
+class FlatScene : public Scene {
+    std::vector<anim::Animation<float>> m_anims;
+    anim::Batch m_batch;
+
+public:
+    FlatScene(std::size_t count) {
+        m_anims.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            m_anims.emplace_back(anim::Interpolator<float> { 0, 1, get_duration(i), get_easing(i) });
+
+        for (auto& anim : m_anims)
+            m_batch.add(anim);
+    }
+
+    void start() override {
+        m_batch.start();
+    }
+
+    float frame() override {
+        float sum = 0.0f;
+        for (auto const& anim : m_anims)
+            sum += anim.get();
+        return sum;
+    }
+};
+
+class Vector2Scene : public Scene {
+    std::vector<anim::Animation<Vector2>> m_anims;
+    anim::Batch m_batch;
+
+public:
+    Vector2Scene(std::size_t count) {
+        m_anims.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            anim::Interpolator<Vector2> interp { { 0, 0 }, { 100, 50 }, get_duration(i), get_easing(i) };
+            m_anims.emplace_back(interp);
+        }
+
+        for (auto& anim : m_anims)
+            m_batch.add(anim);
+    }
+
+    void start() override {
+        m_batch.start();
+    }
+
+    float frame() override {
+        float sum = 0.0f;
+        for (auto const& anim : m_anims)
+            sum += anim.get().x;
+        return sum;
+    }
+};
+
+class TreeScene : public Scene {
+    std::vector<anim::Animation<float>> m_floats;
+    std::vector<anim::Animation<Vector2>> m_vectors;
+    std::vector<anim::Sequence> m_sequences;
+    anim::Batch m_batch;
+
+public:
+    TreeScene(std::size_t count) {
+        std::size_t sequences = (count + SEQUENCE_LENGTH - 1) / SEQUENCE_LENGTH;
+        m_floats.reserve(sequences * SEQUENCE_LENGTH / 2);
+        m_vectors.reserve(sequences * SEQUENCE_LENGTH / 2);
+        m_sequences.resize(sequences);
+
+        for (std::size_t i = 0; i < sequences * SEQUENCE_LENGTH; ++i) {
+            double duration = get_duration(i) / SEQUENCE_LENGTH;
+            auto& sequence = m_sequences[i / SEQUENCE_LENGTH];
+
+            if (i % 2 == 0) {
+                sequence.add(m_floats.emplace_back(anim::Interpolator<float> { 0, 1, duration, get_easing(i) }));
+            } else {
+                anim::Interpolator<Vector2> interp { { 0, 0 }, { 100, 50 }, duration, get_easing(i) };
+                sequence.add(m_vectors.emplace_back(interp));
+            }
+        }
+
+        for (auto& sequence : m_sequences)
+            m_batch.add(sequence);
+    }
+
+    void start() override {
+        m_batch.start();
+    }
+
+    float frame() override {
+        for (auto& sequence : m_sequences)
+            sequence.dispatch();
+
+        float sum = 0.0f;
+        for (auto const& anim : m_floats)
+            sum += anim.get();
+        for (auto const& anim : m_vectors)
+            sum += anim.get().x;
+        return sum;
+    }
+};
+
+class InstancedScene : public Scene {
+    anim::InstancedTrack<float> m_track { { 0, 1, 1, anim::interpolators::ease_in_out_cubic } };
+    std::vector<float> m_values;
+
+public:
+    InstancedScene(std::size_t count) : m_values(count) {
+        m_track.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            m_track.add(0, 1, 0, get_duration(i));
+    }
+
+    void start() override {
+        m_track.start();
+    }
+
+    float frame() override {
+        m_track.get(m_values);
+
+        float sum = 0.0f;
+        for (float value : m_values)
+            sum += value;
+        return sum;
+    }
+};
+
+// mostly idle, as in a UI: every frame starts a slice of the animations,
+// so that one in twenty is running at any time
+class WorldScene : public Scene {
+    std::vector<anim::Animation<float>> m_anims;
+    anim::World<anim::Animation<float>> m_world;
+    std::size_t m_next = 0;
+    std::size_t m_per_frame;
+
+public:
+    WorldScene(std::size_t count) {
+        m_anims.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            m_anims.emplace_back(anim::Interpolator<float> { 0, 1, 1, get_easing(i) });
+
+        // animations last 60 frames
+        m_per_frame = std::max<std::size_t>(count / 20 / 60, 1);
+        m_world.reserve(count / 20 + m_per_frame);
+    }
+
+    void start() override { }
+
+    float frame() override {
+        for (std::size_t i = 0; i < m_per_frame; ++i) {
+            m_world.start(m_anims[m_next]);
+            m_next = (m_next + 1) % m_anims.size();
+        }
+
+        m_world.update();
+
+        float sum = 0.0f;
+        for (auto const* anim : m_world.get_active())
+            sum += anim->get();
+        return sum;
+    }
+};
+
+class SplineScene : public Scene {
+    std::vector<anim::SplineAnimation<Vector2>> m_anims;
+    anim::Batch m_batch;
+
+public:
+    SplineScene(std::size_t count) {
+        static constexpr std::size_t KEYS = 16;
+        std::array<anim::Spline<Vector2>::Key, KEYS> keys;
+
+        m_anims.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            double step = get_duration(i) / (KEYS - 1);
+            for (std::size_t k = 0; k < KEYS; ++k) {
+                auto x = static_cast<float>((i + k * 7) % 13);
+                keys[k] = { k * step, { x * 10, static_cast<float>(k) * 5 } };
+            }
+            m_anims.emplace_back(anim::Spline<Vector2>::catmull_rom(keys));
+        }
+
+        for (auto& anim : m_anims)
+            m_batch.add(anim);
+    }
+
+    void start() override {
+        m_batch.start();
+    }
+
+    float frame() override {
+        float sum = 0.0f;
+        for (auto const& anim : m_anims)
+            sum += anim.get().x;
+        return sum;
+    }
+};
+
+// 64 keys over about 10 seconds, as in a baked track
+static constexpr std::size_t TRACK_KEYS = 64;
+
+[[nodiscard]] static std::array<anim::Spline<float>::Key, TRACK_KEYS> make_track_keys(std::size_t index) {
+    std::array<anim::Spline<float>::Key, TRACK_KEYS> keys;
+    double step = (10.0f + index % 5) / TRACK_KEYS;
+    for (std::size_t k = 0; k < TRACK_KEYS; ++k)
+        keys[k] = { k * step, static_cast<float>((index * 31 + k * 17) % 101) / 100 };
+    return keys;
+}
+
+// the float form of the tracks below, one linear interpolator per key
+class KeysScene : public Scene {
+    std::vector<anim::Animation<float>> m_anims;
+    anim::Batch m_batch;
+
+public:
+    KeysScene(std::size_t count) {
+        m_anims.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto keys = make_track_keys(i);
+            std::vector<anim::Interpolator<float>> interps;
+            interps.reserve(TRACK_KEYS - 1);
+            for (std::size_t k = 0; k + 1 < TRACK_KEYS; ++k)
+                interps.emplace_back(keys[k].value, keys[k + 1].value, keys[k + 1].time - keys[k].time);
+            m_anims.emplace_back(std::move(interps));
+        }
+
+        for (auto& anim : m_anims)
+            m_batch.add(anim);
+    }
+
+    void start() override {
+        m_batch.start();
+    }
+
+    float frame() override {
+        float sum = 0.0f;
+        for (auto const& anim : m_anims)
+            sum += anim.get();
+        return sum;
+    }
+};
+
+class QuantizedScene : public Scene {
+    std::vector<anim::QuantizedAnimation<float>> m_anims;
+    anim::Batch m_batch;
+
+public:
+    QuantizedScene(std::size_t count, anim::Quantization quantization) {
+        m_anims.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            m_anims.emplace_back(anim::QuantizedTrack<float>(make_track_keys(i), quantization));
+
+        for (auto& anim : m_anims)
+            m_batch.add(anim);
+    }
+
+    void start() override {
+        m_batch.start();
+    }
+
+    float frame() override {
+        float sum = 0.0f;
+        for (auto const& anim : m_anims)
+            sum += anim.get();
+        return sum;
+    }
+};
+
+[[nodiscard]] static std::unique_ptr<Scene> make_scene(char const* name, std::size_t count) {
+    if (std::strcmp(name, "flat") == 0) return std::make_unique<FlatScene>(count);
+    if (std::strcmp(name, "tree") == 0) return std::make_unique<TreeScene>(count);
+    if (std::strcmp(name, "vector2") == 0) return std::make_unique<Vector2Scene>(count);
+    if (std::strcmp(name, "instanced") == 0) return std::make_unique<InstancedScene>(count);
+    if (std::strcmp(name, "world") == 0) return std::make_unique<WorldScene>(count);
+    if (std::strcmp(name, "spline") == 0) return std::make_unique<SplineScene>(count);
+    if (std::strcmp(name, "keys") == 0) return std::make_unique<KeysScene>(count);
+    if (std::strcmp(name, "quantized") == 0) return std::make_unique<QuantizedScene>(count, anim::Quantization::Unorm16);
+    if (std::strcmp(name, "half") == 0) return std::make_unique<QuantizedScene>(count, anim::Quantization::Half);
+    return nullptr;
+}
+
+// the same chunk of text is fed repeatedly, so only parsing is measured
+static int run_parse(std::size_t megabytes) {
+    static constexpr std::string_view BLOCK =
+        "batch {\n"
+        "    track { 0 -> 1 0.5 ease_in_out_cubic; 1 -> 0 0.5; }\n"
+        "    track { [0, 0] -> [100, 50] 1 ease_out_back; }\n"
+        "    sequence { track { [0, 0, 0, 255] -> [255, 255, 255, 255] 0.25; } track { 1 -> 0 0.25 ease_in_quad; } }\n"
+        "}\n";
+
+    std::string chunk;
+    while (chunk.size() + BLOCK.size() <= 64 * 1024)
+        chunk += BLOCK;
+
+    std::size_t chunks = std::max<std::size_t>(megabytes * 1024 * 1024 / chunk.size(), 1);
+
+    anim::binary::Writer writer;
+    anim::text::Parser parser(writer);
+
+    double start = now_ms();
+    for (std::size_t i = 0; i < chunks; ++i) {
+        if (!parser.feed(chunk)) {
+            std::fprintf(stderr, "%s\n", parser.get_error().data());
+            return EXIT_FAILURE;
+        }
+    }
+    bool ok = parser.finish();
+    double elapsed = now_ms() - start;
+
+    if (!ok) {
+        std::fprintf(stderr, "%s\n", parser.get_error().data());
+        return EXIT_FAILURE;
+    }
+
+    double mib = chunks * chunk.size() / (1024.0f * 1024.0f);
+    auto compiled = writer.get_size();
+
+    std::printf("scene:         parse\n");
+    std::printf("input:         %.1f MiB\n", mib);
+    std::printf("compiled:      %.1f MiB\n", compiled / (1024.0f * 1024.0f));
+    std::printf("time:          %.1f ms\n", elapsed);
+    std::printf("throughput:    %.1f MiB/s\n", mib / (elapsed / 1000));
+    std::printf("peak rss:      %.1f MiB\n", get_peak_rss_mib());
+
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+
+    char const* name = argc > 1 ? argv[1] : "flat";
+
+    if (std::strcmp(name, "parse") == 0)
+        return run_parse(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100);
+    std::size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100'000;
+    std::size_t frames = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 600;
+
+    if (count == 0 || frames == 0) {
+        std::fprintf(stderr, "Usage: %s [flat|tree|vector2|instanced|world|spline|keys|quantized|half] [animations] [frames]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    anim::set_clock(synthetic_clock);
+
+    double construction_start = now_ms();
+    auto scene = make_scene(name, count);
+    double construction = now_ms() - construction_start;
+
+    if (scene == nullptr) {
+        std::fprintf(stderr, "Unknown scene: %s\n", name);
+        return EXIT_FAILURE;
+    }
+
+    scene->start();
+
+    float sink = 0.0f;
+    double frames_start = now_ms();
+    for (std::size_t i = 0; i < frames; ++i) {
+        s_time += FRAME_TICKS;
+        sink += scene->frame();
+    }
+    double per_frame = (now_ms() - frames_start) / frames;
+
+    std::printf("scene:         %s\n", name);
+    std::printf("animations:    %zu\n", count);
+    std::printf("frames:        %zu (%.1fs)\n", frames, frames * FRAME);
+    std::printf("construction:  %.2f ms\n", construction);
+    std::printf("per frame:     %.3f ms\n", per_frame);
+    std::printf("per animation: %.2f ns\n", per_frame * 1e6 / count);
+    std::printf("peak rss:      %.1f MiB\n", get_peak_rss_mib());
+    std::printf("checksum:      %g\n", sink);
+
+    return EXIT_SUCCESS;
+}